@@ -157,6 +157,35 @@ function addplugin(name)
     
 end
 
+-- Adds the test program at src/tests/<name>, which returns the number of failed checks
+function addtest(name)
+    project(name .. "_tests")
+        configuration {}
+        language "C++"
+        kind "ConsoleApp"
+        flags { "NoPCH" }
+        binarydir "tests"
+        includedirs { "src/tests" }
+        files { "src/tests/testing.hpp" }
+        setupfiles("src/tests/" .. name)
+end
+
+-- Adds the benchmark program at src/bench/<name>, which fails when a measure regresses past its baseline
+function addbench(name)
+    project(name .. "_bench")
+        configuration {}
+        language "C++"
+        kind "ConsoleApp"
+        flags { "NoPCH" }
+        binarydir "bench"
+        includedirs { "src/bench", "src/tests" }
+        files { "src/bench/bench.hpp" }
+        setupfiles("src/bench/" .. name)
+        configuration "windows"
+            links { "psapi" }
+        configuration {}
+end
+
 function dummyproject()
 
     kind "Makefile"
@@ -275,6 +304,16 @@ solution "modloader"
         configuration { "gmake" }
             includedirs { "src/shared/stdinc" } -- gmake compatibility since it'll compile the dummyproject
 
+    addtest "datalib"
+    addtest "std.data"
+        includedirs { "src/plugins/gta3/std.data" }
+    addbench "std.data"
+        includedirs { "src/plugins/gta3/std.data" }
+    addtest "std.stream"
+        includedirs { "src/plugins/gta3/std.stream" }
+    addtest "img"
+    addbench "img"
+
 
     local gta3_plugins = {  -- ordered by time taken to compile
         "std.movies",
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#   include <windows.h>
+#   include <psapi.h>
+#else
+#   include <sys/resource.h>
+#endif
+
+//
+//  Minimal measuring facilities for the benchmark programs
+//  Every measure is printed as it is taken, and may be compared against a baseline written by a previous run.
+//
+//  A benchmark program should define BENCH_COUNT_ALLOCATIONS in exactly one of its translation units before including
+//  this header, so the allocations of the program get counted (see allocations()).
+//
+
+namespace bench
+{
+    // Number of allocations done by the program so far (the merge may allocate from worker threads)
+    inline std::atomic<std::size_t>& allocations()
+    {
+        static std::atomic<std::size_t> count(0);
+        return count;
+    }
+
+    // Peak resident memory of the process so far, in KiB
+    inline std::size_t peak_rss_kib()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc;
+        if(GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return std::size_t(pmc.PeakWorkingSetSize / 1024);
+        return 0;
+#else
+        struct rusage usage;
+        if(getrusage(RUSAGE_SELF, &usage) == 0)
+            return std::size_t(usage.ru_maxrss);   // already in KiB on Linux
+        return 0;
+#endif
+    }
+
+    // Measures the time and the allocations of a stage, from the construction (or restart) to now
+    struct stopwatch
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        clock_type::time_point start;
+        std::size_t            allocs;
+
+        stopwatch()
+        { this->restart(); }
+
+        void restart()
+        {
+            this->allocs = allocations();
+            this->start  = clock_type::now();
+        }
+
+        double seconds() const
+        { return std::chrono::duration<double>(clock_type::now() - start).count(); }
+
+        std::size_t allocated() const
+        { return allocations() - this->allocs; }
+    };
+
+    // A measure, and whether higher values of it are better than lower ones
+    struct measure
+    {
+        double value;
+        bool   higher_is_better;
+    };
+
+    // Measures taken so far by their names
+    inline std::map<std::string, measure>& measures()
+    {
+        static std::map<std::string, measure> list;
+        return list;
+    }
+
+    // Takes and prints a measure
+    inline void report(const std::string& name, double value, const char* unit, bool higher_is_better)
+    {
+        measures()[name] = measure { value, higher_is_better };
+        std::printf("%-40s %14.0f %s\n", name.c_str(), value, unit);
+    }
+
+    // Writes the measures taken so far into 'path', to be used as the baseline of later runs
+    inline bool write_baseline(const std::string& path)
+    {
+        std::ofstream file(path);
+        file << std::fixed << std::setprecision(0);
+        for(auto& m : measures())
+            file << m.first << ' ' << m.second.value << '\n';
+        return bool(file);
+    }
+
+    // Compares the measures taken so far against the baseline at 'path'
+    // A measure regresses when it is worse than its baseline by more than 'tolerance' percent
+    // Returns the number of regressions, or -1 if the baseline could not be read
+    inline int compare_baseline(const std::string& path, double tolerance)
+    {
+        std::ifstream file(path);
+        if(!file)
+            return -1;
+
+        int regressions = 0;
+        std::string name; double base;
+        while(file >> name >> base)
+        {
+            auto it = measures().find(name);
+            if(it == measures().end() || base <= 0.0)
+                continue;
+
+            double value  = it->second.value;
+            double change = (value - base) * 100.0 / base;  // in percent
+            if(it->second.higher_is_better? (change < -tolerance) : (change > tolerance))
+            {
+                ++regressions;
+                std::printf("regression: %s is %.0f, baseline is %.0f (%+.1f%%)\n", name.c_str(), value, base, change);
+            }
+        }
+        return regressions;
+    }
+}
+
+#if defined(BENCH_COUNT_ALLOCATIONS)
+#include <new>
+
+// Counts the allocations of the program (see bench::allocations)
+void* operator new(std::size_t size)
+{
+    ++bench::allocations();
+    if(void* p = std::malloc(size? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete[](void* p) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+#endif
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#define BENCH_COUNT_ALLOCATIONS
+#include <bench.hpp>
+#include <img_parser/img_parser.hpp>
+#include <algorithm>
+#include <limits>
+#include <string>
+
+/*
+ *  Reading of IMG directories
+ *      Generates a .dir file (v1) and a VER2 header (v2) with the same entries, and measures reading them:
+ *          read        -> reading the directory at once (v2) or in big chunks (v1), as std.stream does (img::read)
+ *          parse       -> parsing the directory from memory, as if mapped (img::parse)
+ *          per_entry   -> reading the directory one entry at a time, as the game does
+ */
+
+static const char* usage =
+    "usage: img_bench [options]\n"
+    "  --dir <path>             directory to generate the archives into (current directory)\n"
+    "  --entries <n>            number of entries of each directory (50000)\n"
+    "  --repeat <n>             number of runs of each measure, the best one is taken (5)\n"
+    "  --baseline <path>        fails when a measure is worse than in this baseline\n"
+    "  --tolerance <percent>    how much worse than the baseline a measure may be (25)\n"
+    "  --save-baseline <path>   writes the measures of this run as a baseline\n";
+
+// Writes a directory of 'count' entries to 'path', gives its bytes
+static std::string write_directory(const std::string& path, img::version ver, uint32_t count)
+{
+    std::string bytes;
+    if(ver == img::version::v2)
+    {
+        bytes.append("VER2", 4);
+        bytes.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        img::entry e;
+        std::memset(&e, 0, sizeof(e));
+        e.offset = 1 + i * 8;
+        e.size   = uint16_t(1 + i % 8);
+        std::snprintf(e.name, sizeof(e.name), "%s%u.%s", (i % 3? "model" : "tex"), i, (i % 3? "dff" : "txd"));
+        bytes.append(reinterpret_cast<const char*>(&e), sizeof(e));
+    }
+
+    if(FILE* f = std::fopen(path.c_str(), "wb"))
+    {
+        std::fwrite(bytes.data(), 1, bytes.size(), f);
+        std::fclose(f);
+    }
+    return bytes;
+}
+
+// Reads the directory at 'path' one entry at a time, as the game does
+static size_t read_per_entry(const std::string& path, img::version ver, std::vector<img::entry>& entries)
+{
+    entries.clear();
+    if(FILE* f = std::fopen(path.c_str(), "rb"))
+    {
+        char header[8];
+        img::entry e;
+        if(ver == img::version::v1 || std::fread(header, sizeof(header), 1, f) == 1)
+        {
+            while(std::fread(&e, sizeof(e), 1, f) == 1)
+                entries.emplace_back(e);
+        }
+        std::fclose(f);
+    }
+    return entries.size();
+}
+
+// Reads the directory at 'path' with the library
+static size_t read_bulk(const std::string& path, img::version ver, std::vector<img::entry>& entries)
+{
+    entries.clear();
+    if(FILE* f = std::fopen(path.c_str(), "rb"))
+    {
+        if(img::read(f, std::fread, ver, entries) != img::status::good)
+            entries.clear();
+        std::fclose(f);
+    }
+    return entries.size();
+}
+
+// Measures 'fn' (which gives the number of entries it has read) over 'repeat' runs and reports the best one
+template<class F>
+static bool measure(const std::string& name, size_t count, unsigned repeat, F fn)
+{
+    double best = std::numeric_limits<double>::max();
+    size_t allocs = 0;
+    bool good = true;
+
+    for(unsigned run = 0; run < repeat; ++run)
+    {
+        bench::stopwatch clock;
+        good = (fn() == count) && good;
+        best   = (std::min)(best, clock.seconds());
+        allocs = clock.allocated();
+    }
+
+    bench::report(name + ".entries_per_s", count / (std::max)(best, 1e-9), "entries/s", true);
+    bench::report(name + ".allocations", double(allocs), "allocations", false);
+    return good;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string dir = ".", baseline, save_baseline;
+    unsigned entries = 50000, repeat = 5;
+    double tolerance = 25.0;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc? argv[i + 1] : nullptr);
+
+        if(value == nullptr)
+            return std::printf("%s", usage), 2;
+        else if(arg == "--dir")             dir = value;
+        else if(arg == "--entries")         entries = std::stoul(value);
+        else if(arg == "--repeat")          repeat = (std::max)(unsigned(std::stoul(value)), 1u);
+        else if(arg == "--baseline")        baseline = value;
+        else if(arg == "--tolerance")       tolerance = std::stod(value);
+        else if(arg == "--save-baseline")   save_baseline = value;
+        else
+            return std::printf("%s", usage), 2;
+        ++i;
+    }
+
+    bool good = true;
+    std::vector<img::entry> list;
+    list.reserve(entries);
+
+    for(auto ver : { img::version::v1, img::version::v2 })
+    {
+        std::string name = (ver == img::version::v1? "img.v1" : "img.v2");
+        std::string path = dir + (ver == img::version::v1? "/bench.dir" : "/bench.img");
+        std::string bytes = write_directory(path, ver, entries);
+
+        good = measure(name + ".read", entries, repeat, [&] { return read_bulk(path, ver, list); }) && good;
+        good = measure(name + ".parse", entries, repeat, [&]
+        {
+            return img::parse(bytes.data(), bytes.size(), ver, list) == img::status::good? list.size() : 0;
+        }) && good;
+        good = measure(name + ".per_entry", entries, repeat, [&] { return read_per_entry(path, ver, list); }) && good;
+
+        std::remove(path.c_str());
+    }
+
+    bench::report("peak_rss_kib", double(bench::peak_rss_kib()), "KiB", false);
+
+    if(!good)
+    {
+        std::printf("The directories could not be read\n");
+        return 2;
+    }
+
+    if(save_baseline.size() && !bench::write_baseline(save_baseline))
+    {
+        std::printf("Could not write the baseline '%s'\n", save_baseline.c_str());
+        return 2;
+    }
+
+    if(baseline.size())
+    {
+        int regressions = bench::compare_baseline(baseline, tolerance);
+        if(regressions < 0)
+        {
+            std::printf("Could not read the baseline '%s'\n", baseline.c_str());
+            return 2;
+        }
+        else if(regressions > 0)
+        {
+            std::printf("%d measure(s) regressed past %.0f%% of the baseline\n", regressions, tolerance);
+            return 1;
+        }
+        std::printf("No regression past %.0f%% of the baseline\n", tolerance);
+    }
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include "stages.hpp"
+#include <data_traits/carcols.hpp>
+
+using carcols_traits = basic_carcols_traits<host_data_traits>;
+using carcols_store  = gta3::data_store<carcols_traits, store_map<carcols_traits::key_type, carcols_traits::value_type>>;
+
+// sections function specialization
+namespace datalib {
+    namespace gta3
+    {
+        inline const section_info* sections(const carcols_traits::value_type&)
+        {
+            return carcols_traits::sections();
+        }
+    }
+}
+
+bool bench_carcols(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat)
+{
+    return run_stages<carcols_store>("carcols", corpus::carcols(dir, scale, variants), dir + "/merged.carcols.dat", repeat);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include "corpus.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <functional>
+
+namespace
+{
+    // Deterministic pseudo random numbers, the same seed gives the same numbers on every platform
+    struct random_numbers
+    {
+        uint32_t state;
+
+        explicit random_numbers(uint32_t seed) : state(seed * 2654435761u + 1)
+        {}
+
+        uint32_t next()
+        {
+            this->state = this->state * 1664525u + 1013904223u;
+            return this->state >> 8;
+        }
+
+        bool one_in(uint32_t n)
+        {
+            return next() % n == 0;
+        }
+    };
+
+    // Makes the data line of the entry 'index', modded by 'tweak' (zero is the stock entry)
+    using entry_fn = std::function<std::string(unsigned index, unsigned tweak)>;
+
+    struct section_desc
+    {
+        const char* name;   // nullptr for files without sections or with a section per line
+        unsigned    count;  // number of entries in the stock file
+        entry_fn    entry;
+    };
+
+    // Formats a data line
+    std::string format(const char* fmt, ...)
+    {
+        char buf[512];
+        va_list va;
+        va_start(va, fmt);
+        std::vsnprintf(buf, sizeof(buf), fmt, va);
+        va_end(va);
+        return buf;
+    }
+
+    // Builds the content of the variant 'variant' of a file, the variant zero is the stock file
+    // A modded variant drops some of the stock entries, changes some others and adds its own entries to each section
+    std::string make_variant(const std::vector<section_desc>& sections, unsigned variant, const char* header, const char* footer)
+    {
+        random_numbers random(variant);
+        std::string text = header;
+
+        for(auto& section : sections)
+        {
+            if(section.name)
+                text.append(section.name).push_back('\n');
+
+            for(unsigned i = 0; i < section.count; ++i)
+            {
+                unsigned tweak = 0;
+                if(variant)
+                {
+                    if(random.one_in(64))
+                        continue;
+                    if(random.one_in(16))
+                        tweak = 1 + random.next() % 8;
+                }
+                text.append(section.entry(i, tweak)).push_back('\n');
+            }
+
+            if(variant)
+            {
+                unsigned extra = section.count / 32 + 1;
+                for(unsigned k = 0; k < extra; ++k)
+                    text.append(section.entry(section.count + (variant - 1) * extra + k, 0)).push_back('\n');
+            }
+
+            if(section.name)
+                text.append("end\n");
+        }
+
+        return text.append(footer);
+    }
+
+    // Writes the stock file 'name' and its variants into 'dir'
+    corpus make_corpus(const std::string& dir, const char* name, unsigned variants,
+                       const std::vector<section_desc>& sections, const char* header, const char* footer)
+    {
+        corpus result;
+        for(unsigned v = 0; v <= variants; ++v)
+        {
+            auto text = make_variant(sections, v, header, footer);
+            auto path = dir + "/" + (v? std::to_string(v) + "." : std::string()) + name;
+
+            if(FILE* f = std::fopen(path.c_str(), "wb"))
+            {
+                std::fwrite(text.data(), 1, text.size(), f);
+                std::fclose(f);
+            }
+
+            result.files.emplace_back(std::move(path));
+            result.lines += std::count(text.begin(), text.end(), '\n');
+        }
+        return result;
+    }
+}
+
+// Object types, as in the vehicles.ide, peds.ide and map IDEs of the game
+corpus corpus::ide(const std::string& dir, unsigned scale, unsigned variants)
+{
+    std::vector<section_desc> sections = {
+        { "objs", 4000 * scale, [](unsigned i, unsigned t) {
+            return format("%u, obj%u, txd%u, %u, %u", 100000 + i, i, i / 8, 100 + (i % 25) * 10 + t * 5, (i % 7) * 4);
+        }},
+        { "tobj", 400 * scale, [](unsigned i, unsigned t) {
+            return format("%u, tobj%u, txd%u, %u, %u, %u, %u", 200000 + i, i, i / 8, 150 + (i % 10) * 10, (i % 3) * 4, i % 24, (i + 6 + t) % 24);
+        }},
+        { "cars", 200 * scale, [](unsigned i, unsigned t) {
+            return format("%u, car%u, car%u, car, CAR%u, CAR%uN, null, normal, %u, 0, 0, -1, 0.7, 0.7, 0", 300000 + i, i, i, i, i, 10 + t);
+        }},
+        { "peds", 300 * scale, [](unsigned i, unsigned t) {
+            return format("%u, ped%u, ped%u, CIVMALE, STAT_STREET_GUY, man, 1983, 0, man, %u, 4, PED_TYPE_GEN, VOICE_GEN_RMALE01, VOICE_GEN_RMALE01",
+                          400000 + i, i, i, 1 + t);
+        }},
+        { "txdp", 100 * scale, [](unsigned i, unsigned t) {
+            return format("txd%u, txdparent%u", i, (i + t) % 10);
+        }},
+    };
+    return make_corpus(dir, "object.ide", variants, sections, "# object types\n", "");
+}
+
+// Vehicle handling, as in the handling.cfg of the game
+corpus corpus::handling(const std::string& dir, unsigned scale, unsigned variants)
+{
+    std::vector<section_desc> sections = {
+        { nullptr, 200 * scale, [](unsigned i, unsigned t) {
+            return format("VEH%u %u.0 %u.0 2.5 0.0 0.0 -0.3 85 0.75 0.85 0.5 5 160.0 25.0 20.0 4 D 5.5 0.5 0 35.0 0.8 0.08 0.0 0.28 -0.14 0.5 0.25 "
+                          "0.27 0.23 25000 20200020 504400 1 1 0", i, 1000 + i, 3000 + t * 100);
+        }},
+        { nullptr, 20 * scale, [](unsigned i, unsigned t) {
+            return format("%% VEH%u 0.7 2.0 3.5 0.5 0.2 5.0 0.8 0.9 0.9 0.8 0.95 -1.0 0.5 0.5 0.%u", i * 10, 4 + t);
+        }},
+        { nullptr, 20 * scale, [](unsigned i, unsigned t) {
+            return format("! VEH%u 0.2 0.05 0.55 0.3 0.12 0.35 0.2 0.5 0.3 0.25 0.15 0.3 0.24 0.35 0.%u", i * 10 + 1, 1 + t);
+        }},
+        { nullptr, 20 * scale, [](unsigned i, unsigned t) {
+            return format("$ VEH%u 0.5 0.4 -0.0001 0.0 0.05 -0.003 0.7 -0.5 0.02 -0.005 0.2 0.15 0.10 1.0 0.3 -0.%u 40.0 0.005 0.1 0.995 0.995",
+                          i * 10 + 2, 2 + t);
+        }},
+        { nullptr, 10 * scale, [](unsigned i, unsigned t) {
+            return format("^ %u 1 1 1 0 1 0 1 0 1 0 1 0 1 0 1 0 1 0 1 0 0.5 0.5 0.5 0.5 0.5 0.5 0.5 0.5 0.5 0.5 0.5 0.5 0.%u %u",
+                          i, 5 + t, 1 + i % 4);
+        }},
+    };
+    return make_corpus(dir, "handling.cfg", variants, sections, "; vehicle handling\n", ";the end\n");
+}
+
+// Vehicle colours, as in the carcols.dat of the game
+corpus corpus::carcols(const std::string& dir, unsigned scale, unsigned variants)
+{
+    std::vector<section_desc> sections = {
+        { "col", 128 * scale, [](unsigned i, unsigned t) {
+            return format("%u,%u,%u # %u", (i * 7 + t * 16) % 256, (i * 13) % 256, (i * 29) % 256, i);
+        }},
+        { "car", 200 * scale, [](unsigned i, unsigned t) {
+            return format("car%u, %u,%u, %u,%u, %u,%u", i, i % 128, (i + 1) % 128, (i + 2 + t) % 128, (i + 3) % 128, (i + 4) % 128, (i + 5) % 128);
+        }},
+        { "car4", 20 * scale, [](unsigned i, unsigned t) {
+            return format("car4x%u, %u,%u,%u,%u, %u,%u,%u,%u", i, i % 128, (i + 1) % 128, (i + 2 + t) % 128, (i + 3) % 128,
+                          (i + 4) % 128, (i + 5) % 128, (i + 6) % 128, (i + 7) % 128);
+        }},
+    };
+    return make_corpus(dir, "carcols.dat", variants, sections, "# vehicle colours\n", "");
+}
+
+// Level files, as in the gta.dat of the game, each area has its IDE and its IPL file
+corpus corpus::gtadat(const std::string& dir, unsigned scale, unsigned variants)
+{
+    std::vector<section_desc> sections = {
+        { nullptr, 4, [](unsigned i, unsigned t) {
+            return format("IMG MODELS\\IMG%u%s.IMG", i, t? "MOD" : "");
+        }},
+        { nullptr, 120 * scale, [](unsigned i, unsigned t) {
+            if(i % 2 == 0)
+                return format("IDE DATA\\MAPS\\AREA%u\\AREA%u.IDE", i / 2, i / 2);
+            return format("IPL DATA\\MAPS\\AREA%u\\AREA%u%s.IPL", i / 2, i / 2, t? "_MOD" : "");
+        }},
+        { nullptr, 20 * scale, [](unsigned i, unsigned t) {
+            return format("COLFILE %u DATA\\MAPS\\LEVEL%u.COL", t, i);
+        }},
+    };
+    return make_corpus(dir, "gta.dat", variants, sections, "# level files\nTEXDICTION MODELS\\MISC.TXD\n", "SPLASH loadsc0\n");
+}
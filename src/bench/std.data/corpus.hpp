@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ *  corpus
+ *      A stock like data file and its modded variants, generated into a directory.
+ *      The same arguments always generate the very same files.
+ */
+struct corpus
+{
+    std::vector<std::string> files;     // files[0] is the stock file, the others are the variants
+    std::size_t              lines = 0; // number of lines in all the files
+
+    // Generates the data files of San Andreas, each with 'variants' modded copies.
+    // 'scale' multiplies the number of entries of the stock files.
+    static corpus ide(const std::string& dir, unsigned scale, unsigned variants);
+    static corpus handling(const std::string& dir, unsigned scale, unsigned variants);
+    static corpus carcols(const std::string& dir, unsigned scale, unsigned variants);
+    static corpus gtadat(const std::string& dir, unsigned scale, unsigned variants);
+};
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include "stages.hpp"
+#include <data_traits/gta.dat.hpp>
+
+using gtadat_traits = basic_gtadat_traits<host_data_traits>;
+using gtadat_store  = gta3::data_store<gtadat_traits, store_map<gtadat_traits::key_type, gtadat_traits::value_type>>;
+
+// sections function specialization
+namespace datalib {
+    namespace gta3
+    {
+        inline const section_info* sections(const gtadat_traits::value_type&)
+        {
+            return gtadat_traits::sections();
+        }
+    }
+}
+
+bool bench_gtadat(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat)
+{
+    return run_stages<gtadat_store>("gtadat", corpus::gtadat(dir, scale, variants), dir + "/merged.gta.dat", repeat);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include "stages.hpp"
+#include <data_traits/handling.hpp>
+
+using handling_traits = basic_handling_traits<host_data_traits>;
+using handling_store  = gta3::data_store<handling_traits, store_map<handling_traits::key_type, handling_traits::value_type>>;
+
+// sections function specialization
+namespace datalib {
+    namespace gta3
+    {
+        inline const section_info* sections(const handling_traits::value_type&)
+        {
+            return handling_traits::sections();
+        }
+    }
+}
+
+bool bench_handling(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat)
+{
+    return run_stages<handling_store>("handling", corpus::handling(dir, scale, variants), dir + "/merged.cfg", repeat);
+}
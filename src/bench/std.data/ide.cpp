@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include "stages.hpp"
+#include <data_traits/ide.hpp>
+
+using ide_traits = basic_ide_traits<host_data_traits>;
+using ide_store  = gta3::data_store<ide_traits, store_map<ide_traits::key_type, ide_traits::value_type>>;
+
+// sections function specialization
+namespace datalib {
+    namespace gta3
+    {
+        inline const section_info* sections(const ide_traits::value_type&)
+        {
+            return ide_traits::sections();
+        }
+    }
+}
+
+bool bench_ide(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat)
+{
+    return run_stages<ide_store>("ide", corpus::ide(dir, scale, variants), dir + "/merged.ide", repeat);
+}
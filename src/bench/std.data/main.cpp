@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#define BENCH_COUNT_ALLOCATIONS
+#include <bench.hpp>
+#include <algorithm>
+#include <string>
+#if defined(_WIN32)
+#   include <direct.h>
+#else
+#   include <sys/stat.h>
+#endif
+
+bool bench_ide(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat);
+bool bench_handling(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat);
+bool bench_carcols(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat);
+bool bench_gtadat(const std::string& dir, unsigned scale, unsigned variants, unsigned repeat);
+
+static const char* usage =
+    "usage: std.data_bench [options]\n"
+    "  --dir <path>             directory to generate the corpus into (std.data.corpus)\n"
+    "  --scale <n>              multiplies the number of entries of the stock files (1)\n"
+    "  --variants <n>           number of modded variants of each stock file (8)\n"
+    "  --repeat <n>             number of runs of each stage, the best one is taken (3)\n"
+    "  --baseline <path>        fails when a measure is worse than in this baseline\n"
+    "  --tolerance <percent>    how much worse than the baseline a measure may be (25)\n"
+    "  --save-baseline <path>   writes the measures of this run as a baseline\n";
+
+int main(int argc, char* argv[])
+{
+    std::string dir = "std.data.corpus", baseline, save_baseline;
+    unsigned scale = 1, variants = 8, repeat = 3;
+    double tolerance = 25.0;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc? argv[i + 1] : nullptr);
+
+        if(value == nullptr)
+            return std::printf("%s", usage), 2;
+        else if(arg == "--dir")             dir = value;
+        else if(arg == "--scale")           scale = std::stoul(value);
+        else if(arg == "--variants")        variants = std::stoul(value);
+        else if(arg == "--repeat")          repeat = std::stoul(value);
+        else if(arg == "--baseline")        baseline = value;
+        else if(arg == "--tolerance")       tolerance = std::stod(value);
+        else if(arg == "--save-baseline")   save_baseline = value;
+        else
+            return std::printf("%s", usage), 2;
+        ++i;
+    }
+
+#if defined(_WIN32)
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+
+    bool good = true;
+    good = bench_ide(dir, scale, variants, (std::max)(repeat, 1u)) && good;
+    good = bench_handling(dir, scale, variants, (std::max)(repeat, 1u)) && good;
+    good = bench_carcols(dir, scale, variants, (std::max)(repeat, 1u)) && good;
+    good = bench_gtadat(dir, scale, variants, (std::max)(repeat, 1u)) && good;
+    bench::report("peak_rss_kib", double(bench::peak_rss_kib()), "KiB", false);
+
+    if(!good)
+    {
+        std::printf("The corpus could not be merged\n");
+        return 2;
+    }
+
+    if(save_baseline.size() && !bench::write_baseline(save_baseline))
+    {
+        std::printf("Could not write the baseline '%s'\n", save_baseline.c_str());
+        return 2;
+    }
+
+    if(baseline.size())
+    {
+        int regressions = bench::compare_baseline(baseline, tolerance);
+        if(regressions < 0)
+        {
+            std::printf("Could not read the baseline '%s'\n", baseline.c_str());
+            return 2;
+        }
+        else if(regressions > 0)
+        {
+            std::printf("%d measure(s) regressed past %.0f%% of the baseline\n", regressions, tolerance);
+            return 1;
+        }
+        std::printf("No regression past %.0f%% of the baseline\n", tolerance);
+    }
+
+    return 0;
+}
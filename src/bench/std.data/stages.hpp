@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include <bench.hpp>
+#include <std.data/host.hpp>
+#include "corpus.hpp"
+#include <limits>
+#include <set>
+#include <sstream>
+
+// The cache serialization of std.data (see cache.hpp)
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/array.hpp>
+#include <cereal/types/base_class.hpp>
+#include <cereal/types/bitset.hpp>
+#include <cereal/types/boost_variant.hpp>
+#include <cereal/types/common.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/list.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/set.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/tuple.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/memory.hpp>
+#include <cereal/types/boost_optional.hpp>
+
+/*
+ *  run_stages
+ *      Merges the files of 'data' with stores of type 'StoreType' and measures each stage of it on its own, as std.data runs them:
+ *          parse       -> parsing each file into a store (parse_from_file)
+ *          cache_save  -> serializing the stores into the cache (see data_cache::SaveStore)
+ *          cache_load  -> deserializing the stores from the cache
+ *          dominance   -> finding the dominant data of every key (find_dominant_data)
+ *          merge       -> merging the stores into the file 'outfile' (store_merger)
+ *
+ *      The stores are allocated from a arena, as in a merge session (see caching_stream). The time of a stage is the best
+ *      of 'repeat' runs, reported as lines of the corpus per second, together with the allocations of the stage.
+ *      The peak of the arena (the memory taken by the stores) is reported as well.
+ *      Returns false if any line of the corpus fails to parse or any stage fails.
+ */
+template<class StoreType>
+bool run_stages(const char* name, const corpus& data, const std::string& outfile, unsigned repeat)
+{
+    using traits_type    = typename StoreType::traits_type;
+    using key_type       = typename StoreType::key_type;
+    using allocator_type = typename StoreType::allocator_type;
+
+    static const char* stages[] = { "parse", "cache_save", "cache_load", "dominance", "merge" };
+    static const std::size_t num_stages = sizeof(stages) / sizeof(*stages);
+
+    double      best[num_stages];
+    std::size_t allocs[num_stages];
+    std::fill(std::begin(best), std::end(best), std::numeric_limits<double>::max());
+
+    std::size_t arena_peak = 0;
+    bool good = true;
+    std::size_t failures = host_data_traits::failures();
+
+    for(unsigned run = 0; run < repeat; ++run)
+    {
+        datalib::monotonic_arena arena;
+        std::vector<StoreType> stores, cached;
+        std::stringstream cache;
+        std::set<key_type> keys;
+        std::size_t dominant = 0;
+        std::size_t nstages = 0;
+        bench::stopwatch clock;
+
+        stores.reserve(data.files.size());
+        cached.reserve(data.files.size());
+
+        // Ends the current stage, and starts the next one
+        auto lap = [&]
+        {
+            best[nstages]   = (std::min)(best[nstages], clock.seconds());
+            allocs[nstages] = clock.allocated();
+            ++nstages;
+            clock.restart();
+        };
+
+        clock.restart();
+        for(auto& file : data.files)
+        {
+            stores.emplace_back(allocator_type(&arena));
+            stores.back().set_as_default(stores.size() == 1);
+            good = stores.back().load_from_file(file.c_str()) && good;
+        }
+        lap();
+
+        {
+            cereal::BinaryOutputArchive archive(cache);
+            traits_type::static_serialize(archive, true, [&]
+            {
+                for(auto& store : stores)
+                    archive(store);
+            });
+        }
+        lap();
+
+        {
+            cereal::BinaryInputArchive archive(cache);
+            traits_type::static_serialize(archive, false, [&]
+            {
+                for(std::size_t i = 0; i < stores.size(); ++i)
+                {
+                    cached.emplace_back(allocator_type(&arena));
+                    archive(cached.back());
+                }
+            });
+        }
+        lap();
+
+        for(std::size_t i = 0; i < stores.size(); ++i)
+            good = (cached[i].container().size() == stores[i].container().size()) && good;
+
+        for(auto& store : stores)
+        {
+            for(auto& pair : store.container())
+                keys.emplace(pair.first);
+        }
+
+        clock.restart();
+        for(auto& key : keys)
+        {
+            if(datalib::find_dominant_data(stores.begin(), stores.end(), key, typename traits_type::domflags_fn()(key)))
+                ++dominant;
+        }
+        lap();
+
+        good = gta3::merge_to_file<StoreType>(outfile.c_str(), stores.begin(), stores.end(), typename traits_type::domflags_fn()) && good;
+        lap();
+
+        good = (dominant != 0) && good;
+        arena_peak = arena.peak();
+    }
+
+    for(std::size_t i = 0; i < num_stages; ++i)
+    {
+        std::string prefix = std::string(name) + "." + stages[i];
+        bench::report(prefix + ".lines_per_s", data.lines / (std::max)(best[i], 1e-9), "lines/s", true);
+        bench::report(prefix + ".allocations", double(allocs[i]), "allocations", false);
+    }
+
+    bench::report(std::string(name) + ".arena_peak_kib", double(arena_peak / 1024), "KiB", false);
+
+    if(host_data_traits::failures() != failures)
+    {
+        std::printf("%s: %u line(s) failed to parse\n", name, unsigned(host_data_traits::failures() - failures));
+        good = false;
+    }
+
+    return good;
+}
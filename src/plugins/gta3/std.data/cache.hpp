@@ -626,6 +626,10 @@ class caching_stream
 
     protected:
 
+        // Memory arena for the stores of this merge session, every store in 'store' is constructed with it
+        // All the memory of the stores is given back at once when this object dies
+        datalib::monotonic_arena    arena;
+
         std::string path;       // Path relative to the game dir to the cached data file
         std::string fullpath;   // Fullpath to the above path
         int cache_id;           // Cache directory index that path points to
@@ -723,11 +727,11 @@ class caching_stream
                 this->readme_point = std::distance(this->listing.begin(), readme_point_it);
 
                 this->store.reserve(readme_point + 1);  // reserve one additional elem space for the readme store
-                this->store.resize(readme_point);
                 for(size_t i = 0; i < readme_point; ++i)
                 {
                     bool is_default = this->listing[i].second.is_default;
-                    this->store[i].set_as_default(is_default);
+                    this->store.emplace_back(this->MakeStoreAllocator());
+                    this->store.back().set_as_default(is_default);
                 }
 
                 return true;
@@ -776,8 +780,9 @@ class caching_stream
         {
             assert(this->store.capacity() > this->store.size());
             
-            this->store.emplace_back(this->store.front());  // make it be equivalent to the default file
+            this->store.emplace_back(this->MakeStoreAllocator());
             auto& store = this->store.back();
+            store = this->store.front();                    // make it be equivalent to the default file
 
             for(auto& r : this->readme_data)                // merge content from readme files into the store
                 store.force_merge(r.second.second);
@@ -786,4 +791,11 @@ class caching_stream
             store.set_as_default(false);
         }
 
+    private:
+
+        // Allocator for the stores of this merge session
+        typename StoreType::allocator_type MakeStoreAllocator()
+        {
+            return typename StoreType::allocator_type(&this->arena);
+        }
 };
@@ -810,7 +810,7 @@ struct data_traits : public gta3::data_traits
 
     // make setbyline output a error on failure and take care of eof strings
     template<class StoreType, typename TData>
-    static bool setbyline(StoreType& store, TData& data, const gta3::section_info* section, const std::string& line, bool allowlog = true)
+    static bool setbyline(StoreType& store, TData& data, const gta3::section_info* section, boost::string_ref line, bool allowlog = true)
     {
         if(has_reached_eof(store.traits(), line))
             return false;
@@ -823,9 +823,9 @@ struct data_traits : public gta3::data_traits
         return true;
     }
 
-    static bool fail(const std::string& line)
+    static bool fail(boost::string_ref line)
     {
-        modloader::plugin_ptr->Log("Warning: Failed to parse data line: %s", line.c_str());
+        modloader::plugin_ptr->Log("Warning: Failed to parse data line: %.*s", int(line.size()), line.data());
         return false;
     }
 
@@ -833,10 +833,10 @@ protected:
 
     template<class traits_type>
     typename std::enable_if<traits_type::has_eof_string, bool>::type
-    static /* bool */ has_reached_eof(traits_type& traits, const std::string& line)
+    static /* bool */ has_reached_eof(traits_type& traits, boost::string_ref line)
     {
         static std::string eof_string = traits_type::eof_string();
-        if(traits.eof || !line.compare(0, eof_string.length(), eof_string))
+        if(traits.eof || line.starts_with(eof_string))
         {
             traits.eof = true;
             return true;
@@ -846,7 +846,7 @@ protected:
 
     template<class traits_type>
     typename std::enable_if<!traits_type::has_eof_string, bool>::type
-    static /* bool */ has_reached_eof(traits_type& traits, const std::string& line)
+    static /* bool */ has_reached_eof(traits_type& traits, boost::string_ref line)
     {
         return false;
     }
@@ -28,7 +28,7 @@ struct ar_stats_traits : public data_traits
     }
 };
 
-using ar_stats_store = gta3::data_store<ar_stats_traits, std::map<
+using ar_stats_store = gta3::data_store<ar_stats_traits, store_map<
                         ar_stats_traits::key_type, ar_stats_traits::value_type
                         >>;
 
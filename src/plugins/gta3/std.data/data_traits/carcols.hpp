@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include "../utility.hpp"
+#include <algorithm>
+#include <vector>
+
+/*
+ *  basic_carcols_traits
+ *      The carcols.dat traits over the base traits 'BaseTraits', which should provide setbyline()
+ */
+template<class BaseTraits>
+struct basic_carcols_traits : public BaseTraits
+{
+    static const bool has_sections      = true;     // Does this data file contains sections?
+    static const bool per_line_section  = false;
+
+    // Section slices
+    using col_type  = data_slice<rgb, optional<udata<int>>>;
+    using car_type  = data_slice<modelname, std::vector<std::tuple<uint16_t, uint16_t>>>;
+    using car4_type = data_slice<modelname, std::vector<std::tuple<uint16_t, uint16_t, uint16_t, uint16_t>>>;
+                                        
+    //
+    using key_type   = std::pair<bool, size_t>;  // .first is boolean indicating either col_type or car/car4_type and .second is hash/lineid
+    using value_type = gta3::data_section<col_type, car_type, car4_type>;
+
+    static const gta3::section_info* sections()
+    {
+        // Note: must be in the same order as declared in value_type
+        static auto sections = gta3::make_section_info("col", "car", "car4");
+        static_assert(std::tuple_size<decltype(sections)>::value == 1 + value_type::num_sections, "incompatible sizes");
+        return sections.data();
+    }
+
+    // key_from_value
+    struct key_from_value_visitor : gta3::data_section_visitor<size_t>
+    {
+        template<class T>
+        size_t operator()(const T& slice) const
+        { return hash_model(get<0>(slice)); }
+
+        size_t operator()(const col_type& slice) const
+        { return get(get<1>(slice).get()); }
+
+        size_t operator()(const either_blank& slice) const
+        { throw std::invalid_argument("blank type"); }
+    };
+
+    key_type key_from_value(const value_type& value)
+    {
+        static auto colsec = gta3::section_info::by_name(sections(), "col");
+        key_from_value_visitor visitor;
+        return key_type(value.section() != colsec, value.apply_visitor(visitor));
+    }
+
+    // make setbyline output a error on failure
+    template<class StoreType>
+    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, boost::string_ref line)
+    {
+        static auto colsec = gta3::section_info::by_name(sections(), "col");
+
+        std::string line2;
+        boost::string_ref linep = line;
+
+        // Okay so the 'col' section has a bug in it, Rockstar used a damn '.' instead of a ','
+        if(section == colsec)
+        {
+            line2 = line.to_string();
+            std::replace(line2.begin(), line2.end(), '.', ' ');
+            linep = line2;
+        }
+
+        if(BaseTraits::setbyline(store, data, section, linep))
+        {
+            if(data.section() == colsec)    // assign line index to color info
+                data.get_slice<col_type>().set<1>(make_udata<int>(store.traits().colindex++));
+            return true;
+        }
+
+        return false;
+    }
+
+
+
+    public: // traits data
+
+        int colindex = 0;   // Line index we are going tho for 'col' section
+
+        template<class Archive>
+        void serialize(Archive& archive)
+        { archive(this->colindex); }
+};
@@ -112,7 +112,7 @@ struct carmods_traits : public data_traits
 };
 
 //
-using carmods_store = gta3::data_store<carmods_traits, std::map<
+using carmods_store = gta3::data_store<carmods_traits, store_map<
                         carmods_traits::key_type, carmods_traits::value_type
                         >>;
 
@@ -55,7 +55,7 @@ struct decision_traits : public data_traits
 
     // skips the first line
     template<class StoreType>
-    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, const std::string& line)
+    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, boost::string_ref line)
     {
         auto& traits = store.traits();
         if(!traits.has_first_line)
@@ -84,7 +84,7 @@ public:
     { archive(this->has_first_line); }
 };
 
-using decision_store = gta3::data_store<decision_traits, linear_map<    // linear_map reduces bug chances here because of PedEvent.txt missing events
+using decision_store = gta3::data_store<decision_traits, store_linear_map<    // linear_map reduces bug chances here because of PedEvent.txt missing events
                         decision_traits::key_type, decision_traits::value_type
                         >>;
 
@@ -42,7 +42,7 @@ public:
     { archive(this->eof, this->fistfite_line); }
 };
 
-using fistfite_store = gta3::data_store<fistfite_traits, std::map<
+using fistfite_store = gta3::data_store<fistfite_traits, store_map<
                         fistfite_traits::key_type, fistfite_traits::value_type
                         >>;
 
@@ -5,103 +5,15 @@
  */
 #include <stdinc.hpp>
 #include "../data_traits.hpp"
+#include "ide.hpp"
 #include <traits/gta3/sa.hpp>
 #include <interfaces/gta3/std.stream.hpp>
 using namespace modloader;
-using std::tuple;
 using std::string;
-using ipair = std::pair<int, int>;
-
-namespace { // avoid namespace conflict
-
-enum class PathType : uint8_t {
-    Ped, Car
-};
-
-template<>
-struct enum_map<PathType>
-{
-    static std::map<string, PathType>& map()
-    {
-        static std::map<string, PathType> xmap = {
-            { "ped", PathType::Ped },
-            { "car", PathType::Car },
-        };
-        return xmap;
-    }
-};
-
-} // anon namespace
-
-// Path section data (III)
-using path_head = tuple<PathType, int, dummy_string>;
-using path_carped = tuple<int16_t, int16_t, int16_t, vec3, real_t, optional<tuple<int, int>>>;
-using path_ptr = std::shared_ptr<path_head>;
-using path_key = std::pair<path_ptr, int>;
-
-static bool operator<(const path_ptr& a, const path_ptr& b)
-{ return (*a < *b); }
-
-static bool operator==(const path_ptr& a, const path_ptr& b)
-{ return (*a == *b); }
-
-namespace datalib
-{
-    template<>  // The udata<path_key> should be ignored during the data_slice scan/print
-    struct data_info<udata<path_key>> : data_info_base
-    {
-        static const bool ignore = true;
-    };
-}
-
-namespace std
-{
-    // Output for a path section base pointer
-    template<class CharT, class Traits>
-    static std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const path_ptr& ptr)
-    {
-        return (os << *ptr);
-    }
-}
-
-
-// Aliases of the possible endings of the OBJS and TOBJ lines
-using objs0e = tuple<real_t, int>;
-using objs1e = tuple<int, real_t, int>;
-using objs2e = tuple<int, real_t, real_t, int>;
-using objs3e = tuple<int, real_t, real_t, real_t, int>;
-using tobj0e = tuple<objs0e, int16_t, int16_t>; // use int16 instead of int8 for hours, int8 is readen as character
-using tobj1e = tuple<objs1e, int16_t, int16_t>;
-using tobj2e = tuple<objs2e, int16_t, int16_t>;
-using tobj3e = tuple<objs3e, int16_t, int16_t>;
-
-// Aliases of possible endings of the 2DFX lines (SA)
-// safx<gtasaexe_switch_id>_<read_order_inversed>e    (read order inversed is the order at either<...> inversed)
-using safx8_2e = tuple<int>;
-using safx1_1e = tuple<string>;
-using safx9_3e = tuple<real_t, real_t, int>;
-using safx10_5e = tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, int>;
-using safx6_6e = tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, int, int, string, int>;
-using safx3_7e = tuple<int, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, int, int, string>;
-using safx0_8e = tuple<int, int, int, int, string, string, real_t, real_t, real_t, real_t, int, int, int, int, int, int, int, int, int>;
-using safx7_4e = tuple<real_t, real_t, real_t, real_t, real_t, int, optional<string>, optional<string>, optional<string>, optional<string>>;
-using safx5_9e = tuple<int, real_t, real_t, real_t, real_t, ipair,  ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair>;
-
-// Aliases of possible endings of the 2DFX lines (III/VC)
-// vc3fx_<read_order_inversed>e    (read order inversed is the order at either<...> inversed)
-using vc3fx_4e = tuple<texname, texname, real_t, real_t, real_t, real_t, int, int, int, int, int>;
-using vc3fx_1e = tuple<int, vec3, real_t>;
-using vc3fx_2e = tuple<int, vec3, int>;
-using vc3fx_3e = tuple<int, vec3, vec3>;
-//using vc3fx_0e = tuple<>; -- use optional instead
-
 
 //
-struct ide_traits : public data_traits
+struct ide_traits : public basic_ide_traits<data_traits>
 {
-    static const bool has_sections      = true;     // Does this data file contains sections?
-    static const bool per_line_section  = false;
-
     // Detouring traits
     struct dtraits : modloader::dtraits::OpenFile
     {
@@ -112,116 +24,6 @@ struct ide_traits : public data_traits
     // Detouring type
     using detour_type = modloader::OpenFileDetour<0x5B8428, dtraits>;
 
-    // Section slices
-    using path_type = data_slice<either<path_ptr, path_carped>, udata<path_key>>; // III only
-    using txdp_type = data_slice<texname, texname>; // SA Only
-    using hier_type = data_slice<int, modelname, texname, delimopt, animname, real_t>;  /* (opt args not readen by the game but used in ides) */
-    using anim_type = data_slice<int, modelname, texname, animname, real_t, int>; // SA Only
-    using weap_type = data_slice<int, modelname, texname, animname, int, real_t, delimopt, int>;  // VC/SA only /* (opt args not readen by the game but used in ides) */
-    using objs_type = data_slice<int, modelname, texname, either<objs3e, objs2e, objs1e, SAOnlyFail<objs0e>>>;
-    using tobj_type = data_slice<int, modelname, texname, either<tobj3e, tobj2e, tobj1e, SAOnlyFail<tobj0e>>>;
-    using _2dfx_type= data_slice<int, vec3, VC3Only<tuple<int16_t, int16_t, int16_t, int>>, int,
-                                            VC3Only<optional<either</*vc3fx_5e,*/ vc3fx_4e, vc3fx_3e, vc3fx_2e, vc3fx_1e>>>,
-                                            SAOnly <either<safx5_9e, safx0_8e, safx3_7e, safx6_6e, safx10_5e, safx7_4e, safx9_3e, safx8_2e, safx1_1e>>>;
-    using peds_type = data_slice<int, modelname, texname, string, string, string, hex<uint32_t>, SAOnly<hex<uint32_t>>, SinceVC<tuple<animname, int, int>>, SAOnly<tuple<string, string, string>>>;
-    using cars_type = data_slice<int, modelname, texname, string, string, labelname, SinceVC<animname>, string, int, int, hex<uint32_t>, delimopt, int, real_t, SAOnly<real_t>, SAOnly<int>>;
-
-    // Data
-    using key_type   = either<int, std::size_t, std::tuple<int, vec3, int>, path_key>; // <int> for most sections, <size_t> for txdp, <int, vec3, int> for 2dfx
-    using value_type = gta3::data_section<objs_type, tobj_type, hier_type, anim_type, weap_type, cars_type, peds_type, txdp_type, _2dfx_type, path_type>;
-
-    static const gta3::section_info* sections()
-    {
-        // Note: must be in the same order as declared in value_type
-        static auto sections = gta3::make_section_info("objs", "tobj", "hier", "anim", "weap", "cars", "peds", "txdp", "2dfx", "path");
-        static_assert(std::tuple_size<decltype(sections)>::value == 1 + value_type::num_sections, "incompatible sizes");
-        return sections.data();
-    }
-
-    // key_from_value
-    struct key_from_value_visitor : gta3::data_section_visitor<key_type>
-    {
-        // path section key should be the object being set (type_pedcar, object_id) and the index in the object nodes.
-        key_type operator()(const path_type& slice) const
-        { return datalib::get(get<1>(slice)); }
-
-        // txdp section key should be the child model, since the game sets {child->parent = parent;}
-        key_type operator()(const txdp_type& slice) const
-        { return hash_model(get<0>(slice)); }
-
-        // 2dfx section associates existing models (more than once too) to a 2dfx effect type at a position
-        // so the key should be: first the model id to associate, second the effect position and third the effect type
-        key_type operator()(const _2dfx_type& slice) const
-        { return std::make_tuple(get<0>(slice), get<1>(slice), get<3>(slice)); }
-
-        // all the other section types have a id in the elem0, just pick it as the key
-        template<class T>
-        key_type operator()(const T& slice) const
-        {
-            int id = int(get<0>(slice));
-            if(gvm.IsIII() && id == 199) // lopolyguy
-                return -id; // put this before a ped entry happens, i.e. at the top
-            return id;
-        }
-
-        // and of course the following should never happen
-        key_type operator()(const either_blank&) const
-        { throw std::invalid_argument("blank type"); }
-    };
-
-    key_type key_from_value(const value_type& value)
-    {
-        return value.apply_visitor(key_from_value_visitor());
-    }
-
-    // Path section have to be handled manually
-    template<class StoreType>
-    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, const std::string& line)
-    {
-        static auto pathsec = gta3::section_info::by_name(sections(), "path");
-
-        auto& traits = store.traits();
-        
-        // Path section have to be handled manually
-        if(section == pathsec)
-        {
-            if(gvm.IsIII())
-            {
-                auto& traits = store.traits();
-
-                if(traits.current_path && ++traits.current_path_index > 12)
-                {
-                    traits.current_path = nullptr;
-                }
-
-                if(traits.current_path == nullptr) // not working in a path section yet, or ended a group of paths (12)
-                {
-                    data_slice<path_head> head;
-                    if(head.check(line) && head.set(line))
-                    {
-                        traits.current_path       = traits.add_path(head.get<0>());
-                        traits.current_path_index = 0;
-                        data.set_data(section, path_type(traits.current_path, make_udata<path_key>(traits.current_path, traits.current_path_index)));
-                        return true;
-                    }
-                }
-                else
-                {
-                    data_slice<path_carped> entry;
-                    if(entry.check(line) && entry.set(line))
-                    {
-                        data.set_data(section, path_type(get<0>(entry), make_udata<path_key>(traits.current_path, traits.current_path_index)));
-                        return true;
-                    }
-                }
-            }
-            return fail(line);
-        }
-
-        traits.current_path = nullptr; // not in a path section anymore
-        return data_traits::setbyline(store, data, section, line);
-    }
-
     // Specialize this one so we can filter out IDE readme entries for specific files
     template<class StoreType>
     static DataPlugin::readme_data_list<StoreType>
@@ -270,27 +72,10 @@ struct ide_traits : public data_traits
 
         return list;
     }
-
-public:
-    path_ptr current_path;       // Working header, if on a path section
-    int      current_path_index; // Current index of the working path   
-    std::vector<path_ptr> path_heads;  // List of paths and current index
-
-    path_ptr add_path(const path_head& head)
-    {
-        path_heads.emplace_back(std::make_shared<path_head>(head));
-        return path_heads.back();
-    }
-
-    template<class Archive>
-    void serialize(Archive& archive)
-    {
-        archive(this->path_heads);
-    }
 };
 
 //
-using ide_store = gta3::data_store<ide_traits, std::map<
+using ide_store = gta3::data_store<ide_traits, store_map<
                         ide_traits::key_type, ide_traits::value_type
                         >>;
 
@@ -416,7 +201,9 @@ static std::function<void()> MakeIdeReloader()
         bool mHasAnyChange      = false;
 
         // We need a streaming refresher to perform this, so let's communicate with std.stream
-        IStreamRefresher* refresher = StreamRefresherCreate(STREAMREFRESHER_CAPABILITY_MODEL, 0);
+        // The version 2 interface is preferred, but an older std.stream only provides the first version
+        IStreamRefresher2* refresher2 = StreamRefresherCreate2(STREAMREFRESHER_CAPABILITY_MODEL, 0);
+        IStreamRefresher* refresher = refresher2? refresher2 : StreamRefresherCreate(STREAMREFRESHER_CAPABILITY_MODEL, 0);
         if(!refresher)
         {
             plugin_ptr->Log("Warning: Cannot refresh IDE files because std.stream.dll is missing!");
@@ -486,7 +273,10 @@ static std::function<void()> MakeIdeReloader()
             {
                 BeforeChange();
                 SetTexDictionary(modelinfo, txdname);
-                refresher->RebuildTxdAssociationMap();
+                if(refresher2)
+                    refresher2->UpdateTxdAssociation(mWorkingModelId);
+                else
+                    refresher->RebuildTxdAssociationMap();
             }
         };
 
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include "../utility.hpp"
+#include <map>
+#include <memory>
+#include <vector>
+
+// Path type of the path section (III), its from_string/to_string (see utility.hpp) are found by argument dependent lookup
+enum class PathType : uint8_t {
+    Ped, Car
+};
+
+template<>
+struct enum_map<PathType>
+{
+    static std::map<std::string, PathType>& map()
+    {
+        static std::map<std::string, PathType> xmap = {
+            { "ped", PathType::Ped },
+            { "car", PathType::Car },
+        };
+        return xmap;
+    }
+};
+
+// Path section data (III)
+using path_head = std::tuple<PathType, int, dummy_string>;
+using path_carped = std::tuple<int16_t, int16_t, int16_t, vec3, real_t, optional<std::tuple<int, int>>>;
+using path_ptr = std::shared_ptr<path_head>;
+using path_key = std::pair<path_ptr, int>;
+
+inline bool operator<(const path_ptr& a, const path_ptr& b)
+{ return (*a < *b); }
+
+inline bool operator==(const path_ptr& a, const path_ptr& b)
+{ return (*a == *b); }
+
+namespace datalib
+{
+    template<>  // The udata<path_key> should be ignored during the data_slice scan/print
+    struct data_info<udata<path_key>> : data_info_base
+    {
+        static const bool ignore = true;
+    };
+}
+
+namespace std
+{
+    // Output for a path section base pointer
+    template<class CharT, class Traits>
+    inline std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const path_ptr& ptr)
+    {
+        return (os << *ptr);
+    }
+}
+
+
+using ipair = std::pair<int, int>;
+
+// Aliases of the possible endings of the OBJS and TOBJ lines
+using objs0e = std::tuple<real_t, int>;
+using objs1e = std::tuple<int, real_t, int>;
+using objs2e = std::tuple<int, real_t, real_t, int>;
+using objs3e = std::tuple<int, real_t, real_t, real_t, int>;
+using tobj0e = std::tuple<objs0e, int16_t, int16_t>; // use int16 instead of int8 for hours, int8 is readen as character
+using tobj1e = std::tuple<objs1e, int16_t, int16_t>;
+using tobj2e = std::tuple<objs2e, int16_t, int16_t>;
+using tobj3e = std::tuple<objs3e, int16_t, int16_t>;
+
+// Aliases of possible endings of the 2DFX lines (SA)
+// safx<gtasaexe_switch_id>_<read_order_inversed>e    (read order inversed is the order at either<...> inversed)
+using safx8_2e = std::tuple<int>;
+using safx1_1e = std::tuple<std::string>;
+using safx9_3e = std::tuple<real_t, real_t, int>;
+using safx10_5e = std::tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, int>;
+using safx6_6e = std::tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, int, int, std::string, int>;
+using safx3_7e = std::tuple<int, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, int, int, std::string>;
+using safx0_8e = std::tuple<int, int, int, int, std::string, std::string, real_t, real_t, real_t, real_t, int, int, int, int, int, int, int, int, int>;
+using safx7_4e = std::tuple<real_t, real_t, real_t, real_t, real_t, int, optional<std::string>, optional<std::string>, optional<std::string>, optional<std::string>>;
+using safx5_9e = std::tuple<int, real_t, real_t, real_t, real_t, ipair,  ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair, ipair>;
+
+// Aliases of possible endings of the 2DFX lines (III/VC)
+// vc3fx_<read_order_inversed>e    (read order inversed is the order at either<...> inversed)
+using vc3fx_4e = std::tuple<texname, texname, real_t, real_t, real_t, real_t, int, int, int, int, int>;
+using vc3fx_1e = std::tuple<int, vec3, real_t>;
+using vc3fx_2e = std::tuple<int, vec3, int>;
+using vc3fx_3e = std::tuple<int, vec3, vec3>;
+//using vc3fx_0e = std::tuple<>; -- use optional instead
+
+
+/*
+ *  basic_ide_traits
+ *      The IDE traits over the base traits 'BaseTraits', which should provide setbyline() and fail(line)
+ */
+template<class BaseTraits>
+struct basic_ide_traits : public BaseTraits
+{
+    static const bool has_sections      = true;     // Does this data file contains sections?
+    static const bool per_line_section  = false;
+
+    // Section slices
+    using path_type = data_slice<either<path_ptr, path_carped>, udata<path_key>>; // III only
+    using txdp_type = data_slice<texname, texname>; // SA Only
+    using hier_type = data_slice<int, modelname, texname, delimopt, animname, real_t>;  /* (opt args not readen by the game but used in ides) */
+    using anim_type = data_slice<int, modelname, texname, animname, real_t, int>; // SA Only
+    using weap_type = data_slice<int, modelname, texname, animname, int, real_t, delimopt, int>;  // VC/SA only /* (opt args not readen by the game but used in ides) */
+    using objs_type = data_slice<int, modelname, texname, either<objs3e, objs2e, objs1e, SAOnlyFail<objs0e>>>;
+    using tobj_type = data_slice<int, modelname, texname, either<tobj3e, tobj2e, tobj1e, SAOnlyFail<tobj0e>>>;
+    using _2dfx_type= data_slice<int, vec3, VC3Only<std::tuple<int16_t, int16_t, int16_t, int>>, int,
+                                            VC3Only<optional<either</*vc3fx_5e,*/ vc3fx_4e, vc3fx_3e, vc3fx_2e, vc3fx_1e>>>,
+                                            SAOnly <either<safx5_9e, safx0_8e, safx3_7e, safx6_6e, safx10_5e, safx7_4e, safx9_3e, safx8_2e, safx1_1e>>>;
+    using peds_type = data_slice<int, modelname, texname, std::string, std::string, std::string, hex<uint32_t>, SAOnly<hex<uint32_t>>, SinceVC<std::tuple<animname, int, int>>, SAOnly<std::tuple<std::string, std::string, std::string>>>;
+    using cars_type = data_slice<int, modelname, texname, std::string, std::string, labelname, SinceVC<animname>, std::string, int, int, hex<uint32_t>, delimopt, int, real_t, SAOnly<real_t>, SAOnly<int>>;
+
+    // Data
+    using key_type   = either<int, std::size_t, std::tuple<int, vec3, int>, path_key>; // <int> for most sections, <size_t> for txdp, <int, vec3, int> for 2dfx
+    using value_type = gta3::data_section<objs_type, tobj_type, hier_type, anim_type, weap_type, cars_type, peds_type, txdp_type, _2dfx_type, path_type>;
+
+    static const gta3::section_info* sections()
+    {
+        // Note: must be in the same order as declared in value_type
+        static auto sections = gta3::make_section_info("objs", "tobj", "hier", "anim", "weap", "cars", "peds", "txdp", "2dfx", "path");
+        static_assert(std::tuple_size<decltype(sections)>::value == 1 + value_type::num_sections, "incompatible sizes");
+        return sections.data();
+    }
+
+    // key_from_value
+    struct key_from_value_visitor : gta3::data_section_visitor<key_type>
+    {
+        // path section key should be the object being set (type_pedcar, object_id) and the index in the object nodes.
+        key_type operator()(const path_type& slice) const
+        { return datalib::get(get<1>(slice)); }
+
+        // txdp section key should be the child model, since the game sets {child->parent = parent;}
+        key_type operator()(const txdp_type& slice) const
+        { return hash_model(get<0>(slice)); }
+
+        // 2dfx section associates existing models (more than once too) to a 2dfx effect type at a position
+        // so the key should be: first the model id to associate, second the effect position and third the effect type
+        key_type operator()(const _2dfx_type& slice) const
+        { return std::make_tuple(get<0>(slice), get<1>(slice), get<3>(slice)); }
+
+        // all the other section types have a id in the elem0, just pick it as the key
+        template<class T>
+        key_type operator()(const T& slice) const
+        {
+            int id = int(get<0>(slice));
+            if(gvm.IsIII() && id == 199) // lopolyguy
+                return -id; // put this before a ped entry happens, i.e. at the top
+            return id;
+        }
+
+        // and of course the following should never happen
+        key_type operator()(const either_blank&) const
+        { throw std::invalid_argument("blank type"); }
+    };
+
+    key_type key_from_value(const value_type& value)
+    {
+        key_from_value_visitor visitor;
+        return value.apply_visitor(visitor);
+    }
+
+    // Path section have to be handled manually
+    template<class StoreType>
+    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, boost::string_ref line)
+    {
+        static auto pathsec = gta3::section_info::by_name(sections(), "path");
+
+        auto& traits = store.traits();
+        
+        // Path section have to be handled manually
+        if(section == pathsec)
+        {
+            if(gvm.IsIII())
+            {
+                auto& traits = store.traits();
+
+                if(traits.current_path && ++traits.current_path_index > 12)
+                {
+                    traits.current_path = nullptr;
+                }
+
+                if(traits.current_path == nullptr) // not working in a path section yet, or ended a group of paths (12)
+                {
+                    data_slice<path_head> head;
+                    if(head.set(line))
+                    {
+                        traits.current_path       = traits.add_path(head.get<0>());
+                        traits.current_path_index = 0;
+                        data.set_data(section, path_type(traits.current_path, make_udata<path_key>(traits.current_path, traits.current_path_index)));
+                        return true;
+                    }
+                }
+                else
+                {
+                    data_slice<path_carped> entry;
+                    if(entry.set(line))
+                    {
+                        data.set_data(section, path_type(get<0>(entry), make_udata<path_key>(traits.current_path, traits.current_path_index)));
+                        return true;
+                    }
+                }
+            }
+            return BaseTraits::fail(line);
+        }
+
+        traits.current_path = nullptr; // not in a path section anymore
+        return BaseTraits::setbyline(store, data, section, line);
+    }
+
+public:
+    path_ptr current_path;       // Working header, if on a path section
+    int      current_path_index; // Current index of the working path   
+    std::vector<path_ptr> path_heads;  // List of paths and current index
+
+    path_ptr add_path(const path_head& head)
+    {
+        path_heads.emplace_back(std::make_shared<path_head>(head));
+        return path_heads.back();
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(this->path_heads);
+    }
+};
@@ -116,7 +116,7 @@ struct melee_traits : public data_traits
 
     // Does the manual section handling
     template<class StoreType>
-    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, const std::string& line)
+    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, boost::string_ref line)
     {
         melee_traits& traits = store.traits();
 
@@ -162,7 +162,7 @@ public:
 
 };
 
-using melee_store = gta3::data_store<melee_traits, std::map<
+using melee_store = gta3::data_store<melee_traits, store_map<
                         melee_traits::key_type, melee_traits::value_type
                         >>;
 
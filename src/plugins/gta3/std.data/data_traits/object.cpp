@@ -45,7 +45,7 @@ public: // eof_string related
     { archive(this->eof); }
 };
 
-using object_store = gta3::data_store<object_traits, std::map<
+using object_store = gta3::data_store<object_traits, store_map<
                         object_traits::key_type, object_traits::value_type
                         >>;
 
@@ -49,7 +49,7 @@ public:
     { archive(this->eof, this->particle_line); }
 };
 
-using particle_store = gta3::data_store<particle_traits, std::map<
+using particle_store = gta3::data_store<particle_traits, store_map<
                         particle_traits::key_type, particle_traits::value_type
                         >>;
 
@@ -85,7 +85,7 @@ struct ped_traits : public data_traits
         { archive(this->pedtype); }
 };
 
-using ped_store = gta3::data_store<ped_traits, std::map<
+using ped_store = gta3::data_store<ped_traits, store_map<
                         ped_traits::key_type, ped_traits::value_type
                         >>;
 
@@ -36,7 +36,7 @@ public:
     { archive(this->stat_line); }
 };
 
-using pedstats_store = gta3::data_store<pedstats_traits, std::map<
+using pedstats_store = gta3::data_store<pedstats_traits, store_map<
                         pedstats_traits::key_type, pedstats_traits::value_type
                         >>;
 
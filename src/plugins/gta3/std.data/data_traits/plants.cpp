@@ -30,7 +30,7 @@ struct plants_traits : public data_traits
     }
 };
 
-using plants_store = gta3::data_store<plants_traits, std::map<
+using plants_store = gta3::data_store<plants_traits, store_map<
                         plants_traits::key_type, plants_traits::value_type
                         >>;
 
@@ -30,7 +30,7 @@ struct procobj_traits : public data_traits
     }
 };
 
-using procobj_store = gta3::data_store<procobj_traits, linear_map<
+using procobj_store = gta3::data_store<procobj_traits, store_linear_map<
                         procobj_traits::key_type, procobj_traits::value_type
                         >>;
 
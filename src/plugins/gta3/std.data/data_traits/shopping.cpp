@@ -196,7 +196,7 @@ struct shopping_traits : public data_traits
 
     // Does the manual section handling
     template<class StoreType>
-    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, const std::string& line)
+    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, boost::string_ref line)
     {
         shopping_traits& traits = store.traits();
 
@@ -249,7 +249,7 @@ struct shopping_traits : public data_traits
                 case ShoppingSection::Prices:
                 {
                     data_slice<prices_type> prices;
-                    if(prices.check(line) && prices.set(line))
+                    if(prices.set(line))
                     {
                         data = value_type(std::move(prices.get<0>()), traits.secinfo_udata());
                         return true;
@@ -260,7 +260,7 @@ struct shopping_traits : public data_traits
                 case ShoppingSection::Shops:
                 {
                     data_slice<shops_type> shops;
-                    if(shops.check(line) && shops.set(line))
+                    if(shops.set(line))
                     {
                         data = value_type(std::move(shops.get<0>()), traits.secinfo_udata());
                         return true;
@@ -295,7 +295,7 @@ public:
 //  Merger Initializer
 //
 
-using shopping_store = gta3::data_store<shopping_traits, std::map<
+using shopping_store = gta3::data_store<shopping_traits, store_map<
                         shopping_traits::key_type, shopping_traits::value_type
                         >>;
 
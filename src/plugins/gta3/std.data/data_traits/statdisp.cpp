@@ -55,7 +55,7 @@ public:
     { archive(this->msg_line); }
 };
 
-using statdisp_store = gta3::data_store<statdisp_traits, std::map<
+using statdisp_store = gta3::data_store<statdisp_traits, store_map<
                         statdisp_traits::key_type, statdisp_traits::value_type
                         >>;
 
@@ -29,7 +29,7 @@ struct streamini_traits : public data_traits
     }
 };
 
-using streamini_store = gta3::data_store<streamini_traits, std::map<
+using streamini_store = gta3::data_store<streamini_traits, store_map<
                         streamini_traits::key_type, streamini_traits::value_type
                         >>;
 
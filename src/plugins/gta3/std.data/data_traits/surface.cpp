@@ -37,7 +37,7 @@ public:
     { archive(this->adhesion_line); }
 };
 
-using surface_store = gta3::data_store<surface_traits, std::map<
+using surface_store = gta3::data_store<surface_traits, store_map<
                         surface_traits::key_type, surface_traits::value_type
                         >>;
 
@@ -30,7 +30,7 @@ struct surfaud_traits : public data_traits
     }
 };
 
-using surfaud_store = gta3::data_store<surfaud_traits, std::map<
+using surfaud_store = gta3::data_store<surfaud_traits, store_map<
                         surfaud_traits::key_type, surfaud_traits::value_type
                         >>;
 
@@ -29,7 +29,7 @@ struct surfinfo_traits : public data_traits
     }
 };
 
-using surfinfo_store = gta3::data_store<surfinfo_traits, std::map<
+using surfinfo_store = gta3::data_store<surfinfo_traits, store_map<
                         surfinfo_traits::key_type, surfinfo_traits::value_type
                         >>;
 
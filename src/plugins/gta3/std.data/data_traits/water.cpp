@@ -32,7 +32,7 @@ static void set_xyz_detail(std::integral_constant<size_t, N>, std::array<xyz, N>
 template<size_t I, size_t N, class value_type>
 static void set_xyz_detail(std::integral_constant<size_t, I>, std::array<xyz, N>& pos, const value_type& data)
 {
-    pos[I] = make_xyz(const_cast<value_type&>(data).get<I>());
+    pos[I] = make_xyz(data.get<I>());
     return set_xyz_detail(std::integral_constant<size_t, I+1>(), pos, data);
 }
 
@@ -72,7 +72,7 @@ struct water_traits : public data_traits
     }
 
     template<class StoreType>
-    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, const std::string& line)
+    static bool setbyline(StoreType& store, value_type& data, const gta3::section_info* section, boost::string_ref line)
     {
         if(line[0] != '*' && line[0] != 'p')    // the water.dat parser from the game ignores such cases, so we do.
             return gta3::data_traits::setbyline(store, data, section, line);
@@ -80,7 +80,7 @@ struct water_traits : public data_traits
     }
 };
 
-using water_store = gta3::data_store<water_traits, std::map<
+using water_store = gta3::data_store<water_traits, store_map<
                         water_traits::key_type, water_traits::value_type
                         >>;
 
@@ -102,7 +102,7 @@ struct weapon_traits_sa : public data_traits
     }
 
     // Returns the section pointer for the current line
-    static const gta3::section_info* section_by_line(const gta3::section_info* sections, const std::string& line)
+    static const gta3::section_info* section_by_line(const gta3::section_info* sections, boost::string_ref line)
     {
         static auto meleesec = gta3::section_info::by_name(sections, "\xA3", -1);
         auto section = section_by_line_noeof(sections, line);
@@ -113,7 +113,7 @@ struct weapon_traits_sa : public data_traits
     }
 
     // Returns the section pointer for the current line ignoring the case of eof_string
-    static const gta3::section_info* section_by_line_noeof(const gta3::section_info* sections, const std::string& line)
+    static const gta3::section_info* section_by_line_noeof(const gta3::section_info* sections, boost::string_ref line)
     {
         static auto meleesec = gta3::section_info::by_name(sections, "\xA3", -1);
         static auto gunsec = gta3::section_info::by_name(sections, "$", -1);
@@ -137,7 +137,7 @@ public: // eof_string related
 
 //
 template<typename Traits>
-using weapon_store = gta3::data_store<Traits, std::map<
+using weapon_store = gta3::data_store<Traits, store_map<
                         typename Traits::key_type, typename Traits::value_type
                         >>;
 
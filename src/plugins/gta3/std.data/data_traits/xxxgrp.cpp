@@ -36,7 +36,7 @@ struct xxxgrp_traits : public data_traits
     }
 
     template<typename StoreType, typename TData>
-    static bool setbyline(StoreType& store, TData& data, const gta3::section_info* section, const std::string& line)
+    static bool setbyline(StoreType& store, TData& data, const gta3::section_info* section, boost::string_ref line)
     {
         if(gvm.IsVC())
         {
@@ -46,9 +46,7 @@ struct xxxgrp_traits : public data_traits
             size_t comment_pos = line.find("//");
             if(comment_pos != line.npos)
             {
-                std::string fixed_line = line;
-                fixed_line.erase(comment_pos);
-                return data_traits::setbyline(store, data, section, fixed_line);
+                return data_traits::setbyline(store, data, section, line.substr(0, comment_pos));
             }
         }
         return data_traits::setbyline(store, data, section, line);
@@ -145,7 +143,7 @@ struct pedgrp_traits : public xxxgrp_traits
 
 
 template<class Traits>
-using xxxgrp_store = gta3::data_store<Traits, std::map<
+using xxxgrp_store = gta3::data_store<Traits, store_map<
                         typename Traits::key_type, typename Traits::value_type
                         >>;
 
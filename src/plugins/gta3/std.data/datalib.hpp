@@ -11,6 +11,11 @@
 
 // You may define DATALIB_FAST_COMPILATION on the compiler defines to increase compilation time for the project (!?)
 
+// Data slices are stored by the hundreds of thousands during a merge, so use the packed (smaller) representation of them
+#ifndef DATALIB_DATASLICE_PACKED
+#   define DATALIB_DATASLICE_PACKED
+#endif
+
 // datalib fundamentals
 #include <datalib/data_slice.hpp>
 #include <datalib/dominance.hpp>
@@ -18,6 +23,7 @@
 
 // additional types
 #include <datalib/detail/linear_map.hpp>
+#include <datalib/detail/monotonic_arena.hpp>
 #include <type_wrapper/floating_point.hpp>
 #include <type_wrapper/datalib/io/floating_point.hpp>
 
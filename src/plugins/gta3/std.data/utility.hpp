@@ -3,6 +3,7 @@
  * Licensed under the MIT License, see LICENSE at top level directory.
  * 
  */
+#pragma once
 #include "datalib.hpp"
 #include <modloader/util/hash.hpp>
 #include <modloader/util/container.hpp>
@@ -22,28 +23,155 @@ inline void serialize(Archive& ar, type_wrapper<T, Base>& tw)
 //
 //  Case insensitive string type
 //
+//  A insen string carries the case folded hash of its string in its tag, computed whenever the string is constructed or
+//  assigned, so the equality between two insen strings and the hashing of them become integer operations instead of case
+//  insensitive string operations in most cases. The ordering stays lexical.
+//  The string itself keeps its original spelling, which is what gets printed and serialized.
+//
+//  NOTICE: The string is read only through get(), when changing the string in place (through .first) call refold() afterwards!!!
+//
 struct tag_insen_t {};
 
-template<class T>
-using insen = tagged_type<T, tag_insen_t>;
+namespace datalib
+{
+    template<>
+    struct tag_t<tag_insen_t>
+    {
+        using tag_type = tag_insen_t;
 
-template<class T>
-bool operator==(const insen<T>& a, const insen<T>& b)
-{ return (modloader::compare(get(a), get(b), false)) == 0; }
+        // Folds (in a case insensitive manner) the hash of the specified string into this tag
+        template<class T>
+        void fold(const T& str)
+        {
+            this->hash = modloader::hash(str, ::tolower);
+        }
 
-template<class T>
-bool operator<(const insen<T>& a, const insen<T>& b)
-{ return (modloader::compare(get(a), get(b), false)) < 0; }
+        // Gets the folded hash of the string this tag is paired with
+        std::size_t folded_hash() const
+        {
+            return this->hash;
+        }
 
-template<class... Args>
-inline insen<std::string> make_insen_string(Args&&... args)
-{
-    return make_tagged_type<insen<std::string>>(std::forward<Args>(args)...);
+        bool operator==(const tag_t& rhs) const { return true; }     // Always
+        bool operator<(const tag_t& rhs)  const { return false; }    // ...equal
+
+        private:
+            std::size_t hash = 0;
+    };
+
+    // Lives in the datalib namespace so the datalib I/O of tagged types is found for it
+    // The tag is a template argument (never anything else than tag_insen_t) so that the global namespace stays associated
+    // with insen types, as it was when insen was an alias for the tagged type. The global operators of types built over
+    // insen strings (e.g. the sections of animgrp.dat) are found by argument dependent lookup on it.
+    template<class T, class Tag = tag_insen_t>
+    struct insen : tagged_type<T, Tag>
+    {
+        using base_type = tagged_type<T, Tag>;
+
+        insen()
+        { this->refold(); }
+
+        explicit insen(T str) : base_type(std::move(str), {})
+        { this->refold(); }
+
+        insen(const insen&) = default;
+        insen(insen&&) = default;
+        insen& operator=(const insen&) = default;
+        insen& operator=(insen&&) = default;
+
+        insen& operator=(T str)
+        {
+            this->first = std::move(str);
+            return this->refold();
+        }
+
+        // Refolds the hash of the string, should be called whenever the string changes in place
+        insen& refold()
+        {
+            this->second.fold(this->first);
+            return *this;
+        }
+    };
+
+    // Gets the string in a insen object, read only so the folded hash cannot go out of sync
+    template<class T>
+    inline const T& get(const insen<T>& s)
+    {
+        return s.first;
+    }
+
+    // Gets the case folded hash of a insen string
+    template<class T>
+    inline std::size_t folded_hash(const insen<T>& s)
+    {
+        return s.second.folded_hash();
+    }
+
+    // Refolds the hash of a insen string, should be called whenever the string changes in place
+    template<class T>
+    inline insen<T>& refold(insen<T>& s)
+    {
+        return s.refold();
+    }
+
+    template<class T>
+    bool operator==(const insen<T>& a, const insen<T>& b)
+    {
+        // Different folded hashes never compare equal, equal hashes still need a check against collisions
+        return folded_hash(a) == folded_hash(b)
+            && (modloader::compare(get(a), get(b), false)) == 0;
+    }
+
+    template<class T>
+    bool operator<(const insen<T>& a, const insen<T>& b)
+    {
+        // Lexical order, the order of the merged output depends on it (e.g. the sections of animgrp.dat)
+        return (modloader::compare(get(a), get(b), false)) < 0;
+    }
+
+    template<class... Args>
+    inline insen<std::string> make_insen_string(Args&&... args)
+    {
+        return insen<std::string>(std::string(std::forward<Args>(args)...));
+    }
+
+    // Serializer for insen<>, the folded hash isn't serialized (so the format is the same as any other tagged type) but recomputed on load
+    template<class Archive, class T>
+    inline void serialize(Archive& ar, insen<T>& s)
+    {
+        ar(s.first);
+        refold(s);
+    }
+
+    // Parsing a insen string folds its hash right away
+    template<class CharT, class Traits, class T> inline
+    datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, insen<T>& s)
+    {
+        if(is >> s.first) refold(s);
+        return is;
+    }
+
+    // Precomparing insen strings is just comparing their folded hashes
+    template<class T>
+    struct data_info<insen<T>> : data_info_tagged<tagged_type<T, tag_insen_t>>
+    {
+        static bool precompare(const insen<T>& a, const insen<T>& b)
+        {
+            return folded_hash(a) == folded_hash(b);
+        }
+    };
 }
 
 //
 // Useful types to use on our gta3 data processing
 //
+
+// Containers for the data stores, those allocate from the arena given to the store, see caching_stream
+template<class Key, class Value>
+using store_map = std::map<Key, Value, std::less<Key>, datalib::arena_allocator<std::pair<const Key, Value>>>;
+template<class Key, class Value>
+using store_linear_map = datalib::linear_map<Key, Value, std::equal_to<Key>, datalib::arena_allocator<std::pair<Key, Value>>>;
+
 using dummy_value = datalib::delimopt;
 using real_t = basic_floating_point<float, floating_point_comparer::relative_epsilon<float>>;
 template<class T, std::size_t N>
@@ -84,11 +212,24 @@ inline size_t hash_model(const std::string& model)
     return modloader::hash(model, ::tolower);
 }
 
-// Hashes a string in a case insensitive manner
+// Hashes a string in a case insensitive manner (uses the hash folded on construction)
 template<class T>
 size_t hash_model(const insen<T>& model)
 {
-    return hash_model(get(model));
+    return folded_hash(model);
+}
+
+namespace datalib
+{
+    // Case insensitive strings must be hashed in a case insensitive manner
+    template<class T>
+    struct data_hash<insen<T>>
+    {
+        std::size_t operator()(const insen<T>& model) const
+        {
+            return hash_model(model);
+        }
+    };
 }
 
 
@@ -257,29 +398,27 @@ template<typename T>
 struct enum_map : invalid_enum_map_t
 { /* specialize a [static map<string, T>& map() {}] method */ };
 
-namespace datalib
+// Conversions from/to strings of the enumerations with a enum_map, found by argument dependent lookup (see datalib/io/enum.hpp)
+template<class T> inline
+typename std::enable_if<std::is_enum<T>::value && !std::is_base_of<invalid_enum_map_t, enum_map<T>>::value, T&>::type
+/* T& */ from_string(const std::string& str, T& value)
 {
-    template<class T> inline
-    typename std::enable_if<std::is_enum<T>::value && !std::is_base_of<invalid_enum_map_t, enum_map<T>>::value, T&>::type
-    /* T& */ from_string(const std::string& str, T& value)
-    {
-        auto& map = enum_map<T>::map();
-        auto it = map.find(str);
-        if(it != map.end()) return (value = it->second);
-        throw std::invalid_argument("Invalid conversion from string to enum");
-    }
+    auto& map = enum_map<T>::map();
+    auto it = map.find(str);
+    if(it != map.end()) return (value = it->second);
+    throw std::invalid_argument("Invalid conversion from string to enum");
+}
 
-    template<class T> inline
-    typename std::enable_if<std::is_enum<T>::value && !std::is_base_of<invalid_enum_map_t, enum_map<T>>::value, const std::string&>::type
-    /* const std::string& */ to_string(T value)
+template<class T> inline
+typename std::enable_if<std::is_enum<T>::value && !std::is_base_of<invalid_enum_map_t, enum_map<T>>::value, const std::string&>::type
+/* const std::string& */ to_string(T value)
+{
+    for(auto& x : enum_map<T>::map())
     {
-        for(auto& x : enum_map<T>::map())
-        {
-            if(x.second == value)
-                return x.first;
-        }
-        throw std::invalid_argument("Invalid conversion from enum to string");
+        if(x.second == value)
+            return x.first;
     }
+    throw std::invalid_argument("Invalid conversion from enum to string");
 }
 
 //
@@ -298,44 +437,41 @@ enum class DashValue : uint8_t { // "-" value
     Dash
 };
 
-namespace datalib
+inline EndString& from_string(const std::string& str, EndString& value)
 {
-    inline EndString& from_string(const std::string& str, EndString& value)
-    {
-        if(str == "end") return (value = EndString::End);
-        throw std::invalid_argument("Invalid conversion from string to enum");
-    }
+    if(str == "end") return (value = EndString::End);
+    throw std::invalid_argument("Invalid conversion from string to enum");
+}
 
-    inline const std::string& to_string(EndString value)
-    {
-        static std::string str = "end";
-        return str;
-    }
+inline const std::string& to_string(EndString value)
+{
+    static std::string str = "end";
+    return str;
+}
 
-    inline SectionString& from_string(const std::string& str, SectionString& value)
-    {
-        if(str == "section") return (value = SectionString::Section);
-        throw std::invalid_argument("Invalid conversion from string to enum");
-    }
+inline SectionString& from_string(const std::string& str, SectionString& value)
+{
+    if(str == "section") return (value = SectionString::Section);
+    throw std::invalid_argument("Invalid conversion from string to enum");
+}
 
-    inline const std::string& to_string(SectionString value)
-    {
-        static std::string str = "section";
-        return str;
-    }
+inline const std::string& to_string(SectionString value)
+{
+    static std::string str = "section";
+    return str;
+}
 
-    inline DashValue& from_string(const std::string& str, DashValue& value)
-    {
-        if(str.size() && str[0] == '-') return (value = DashValue::Dash);
-        throw std::invalid_argument("Invalid conversion from string to enum");
-    }
+inline DashValue& from_string(const std::string& str, DashValue& value)
+{
+    if(str.size() && str[0] == '-') return (value = DashValue::Dash);
+    throw std::invalid_argument("Invalid conversion from string to enum");
+}
 
-    inline const std::string& to_string(DashValue value)
-    {
-        static std::string str = "-";
-        return str;
-    }
-};
+inline const std::string& to_string(DashValue value)
+{
+    static std::string str = "-";
+    return str;
+}
 
 
 //
@@ -432,15 +568,12 @@ namespace datalib
         }
         return is;
     }
-}
 
-namespace std
-{
     /*
     *  Input
     */
     template<class CharT, class Traits, size_t GameFlag, class T> inline
-        std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, only_game<GameFlag, T>& og)
+        datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, only_game<GameFlag, T>& og)
     {
         if(og.check_game())
         {
@@ -456,7 +589,10 @@ namespace std
         }
         return is;
     }
+}
 
+namespace std
+{
     /*
     *  Output
     */
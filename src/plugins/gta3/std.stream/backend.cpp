@@ -6,6 +6,7 @@
  */
 #include <stdinc.hpp>
 #include "streaming.hpp"
+#include "scheduler.hpp"
 using namespace modloader;
 
 extern "C"
@@ -51,6 +52,7 @@ extern "C"
             plugin_ptr->Log("Resource id %d has been deleted from disk, falling back to stock model.", id);
             streaming->FallbackResource(id, true);   // forceful but safe since we are before info setup in RequestModelStream
         }
+        streaming->PrefetchAfter(id);
     }
 
     static HANDLE __stdcall CreateFileForCdStream(
@@ -79,9 +81,177 @@ extern "C"
 
 
 
+/*
+ *  CdStreamIO
+ *      Performs the reads requested to the streaming thread on the game's streams, dispatched by a StreamScheduler
+ *      Each I/O worker has its own overlapped event, since parallel reads on the same (overlapped) cd image handle
+ *      must not wait on the handle itself.
+ */
+class CdStreamIO
+{
+    public:
+        using token_type = CAbstractStreaming::AbctFileHandle*;     // The abstract file a piece has been read from, if any
+
+    private:
+        CdStream**          ppStreams;
+        std::vector<HANDLE> events;         // Overlapped event of each worker
+        int                 priority;       // Priority of the streaming thread, the workers run with the same priority
+
+    public:
+        CdStreamIO(CdStream** ppStreams, int num_workers) :
+            ppStreams(ppStreams), priority(GetThreadPriority(GetCurrentThread()))
+        {
+            for(int i = 0; i < num_workers; ++i)
+            {
+                HANDLE hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+                if(hEvent == nullptr) break;
+                events.emplace_back(hEvent);
+            }
+        }
+
+        ~CdStreamIO()
+        {
+            for(auto hEvent : events)
+                CloseHandle(hEvent);
+        }
+
+        // Number of workers there are overlapped events for
+        int Workers() const
+        {
+            return int(events.size());
+        }
+
+        void Begin(int i)
+        {
+            Stream(i)->bInUse = true;   // Mark the stream as under work
+        }
+
+        token_type Read(int i, int worker)
+        {
+            return Read(Stream(i), worker >= 0? events[worker] : nullptr);
+        }
+
+        void Finish(int i, token_type sfile)
+        {
+            Finish(Stream(i), sfile);
+        }
+
+        void WorkerStarted(int)
+        {
+            SetThreadPriority(GetCurrentThread(), this->priority);
+        }
+
+    private:
+        CdStream* Stream(int i)
+        {
+            return &((*ppStreams)[i]);
+        }
+
+        // Reads the piece requested on the stream 'cd' and sets its status
+        // When 'hEvent' isn't null it's used as the overlapped event for the read
+        // Returns the abstract file the piece has been read from, if any
+        static CAbstractStreaming::AbctFileHandle* Read(CdStream* cd, HANDLE hEvent)
+        {
+            bool bIsAbstract = false;
+            CAbstractStreaming::AbctFileHandle* sfile = nullptr;
+
+            if(cd->status == 0)
+            {
+                // Setup vars
+                uint32_t bsize  = cd->nSectorsToRead;
+                uint64_t offset = uint64_t(cd->nSectorOffset)  << 11;   // translate 2KiB based offset to actual offset
+                uint32_t size   = uint32_t(bsize) << 11;                // translate 2KiB based size to actual size
+                HANDLE hFile    = (HANDLE) cd->hFile;
+                bool bResult    = false;
+                const char* filename = nullptr; int index = -1; // When abstract those fields are valid
+
+                // Try to find abstract file from hFile
+                if(sfile = streaming->stm_files.Find(hFile))
+                {
+                    bIsAbstract = true;
+
+                    // Setup vars based on abstract file
+                    offset = sfile->offset;
+                    size   = (uint32_t) sfile->info->file->size;
+                    bsize  = GetSizeInBlocks(size);
+                    index  = sfile->index;
+                    filename = sfile->info->file->filepath();
+                }
+
+#if !defined(NDEBUG) && 0
+                plugin_ptr->Log("$$$$$$$$$ CdStreamThread streaming (%u) model %u offset %llu size %u", bIsAbstract,   
+                                                                                    ReadMemory<uint32_t>(raw_ptr(0x8E4A60 + (i * 38 * 4)/*(i * 0xB480)*/)),
+                                                                                    offset, size);                                                       
+#endif
+
+                // The file may be in memory already
+                if(bIsAbstract && streaming->ReadFromMemory(sfile, cd->lpBuffer))
+                {
+                    bResult = true;
+                }
+                else
+                {
+                    // Setup overlapped structure
+                    LARGE_INTEGER offset_li;
+                    DWORD nBytesReaden;
+                    offset_li.QuadPart        = offset;
+                    cd->overlapped.Offset     = offset_li.LowPart;
+                    cd->overlapped.OffsetHigh = offset_li.HighPart;
+
+                    // Reads in parallel on the same (overlapped) cd image handle must not wait on the handle itself
+                    // The game's event is put back once the read is done
+                    HANDLE hGameEvent = cd->overlapped.hEvent;
+                    if(hEvent) cd->overlapped.hEvent = hEvent;
+
+                    // Read the stream
+                    if(ReadFile(hFile, cd->lpBuffer, size, &nBytesReaden, &cd->overlapped))
+                    {
+                        bResult = true;
+                    }
+                    else
+                    {
+                        if(GetLastError() == ERROR_IO_PENDING)
+                        {
+                            // This happens when the stream was open for async operations, let's wait until everything has been read
+                            // As noted on MSDN [http://msdn.microsoft.com/en-us/library/windows/desktop/aa363858(v=vs.85).aspx], when
+                            // you open a stream with FILE_FLAG_NO_BUFFERING  (R* does that with their cd streams) it gives you maximum
+                            // performance if you use overlapped I/O
+                            bResult = GetOverlappedResult(hFile, &cd->overlapped, &nBytesReaden, true) != 0;
+                        }
+                    }
+
+                    cd->overlapped.hEvent = hGameEvent;
+                }
+
+                // There's some real problem if we can't load a abstract model
+                if(bIsAbstract && !bResult)
+                    plugin_ptr->Log("Warning: Failed to load abstract model file %s; error code: 0x%X", filename, GetLastError());
+                else if(bIsAbstract)
+                    streaming->KeepInMemory(sfile, cd->lpBuffer);
+
+
+                // Set the cdstream status, 0 for "okay" and 254 for "failed to read"
+                cd->status = bResult? 0 : 254;
+            }
+
+            return sfile;
+        }
+
+        // Finishes the request on the stream 'cd', after it has been removed from its queue
+        static void Finish(CdStream* cd, CAbstractStreaming::AbctFileHandle* sfile)
+        {
+            // Cleanup
+            if(sfile) streaming->CloseModel(sfile);
+            cd->nSectorsToRead = 0;
+            if(cd->bLocked) ReleaseSemaphore(cd->semaphore, 1, 0);
+            cd->bInUse = false;
+        }
+};
+
+
 /*
  *  Streaming thread
- *      This thread reads pieces from cd images and in mod loader on disk files
+ *      This thread takes the requests to read pieces from cd images and in mod loader on disk files
  */
 int __stdcall CdStreamThread()
 {
@@ -104,97 +274,23 @@ int __stdcall CdStreamThread()
         ppStreams = memory_pointer(xVc(0x6F76FC)).get<CdStream*>();
     }
 
+    // The game queue has room for a request of each channel plus one, the channels are read by a worker each
+    int channels = (std::max)(pQueue->size - 1, 1);
+    CdStreamIO io(ppStreams, channels);
+    StreamScheduler<CdStreamIO> scheduler(io, io.Workers());
+    plugin_ptr->Log("Streaming thread running with %d I/O workers.", (std::max)(scheduler.Workers(), 1));
+
     // Loop in search of things to load in the queue
     while(true)
     {
-        bool bIsAbstract = false;
-        CAbstractStreaming::AbctFileHandle* sfile = nullptr;
-        
         // Wait until there's something to be loaded...
         WaitForSingleObject(*pSemaphore, -1);
         
         // Take the stream index from the queue
         int i = GetFirstInQueue(pQueue);
         if(i == -1) continue;
-        
-        CdStream* cd = &((*ppStreams)[i]);
-        cd->bInUse = true;          // Mark the stream as under work
-        if(cd->status == 0)
-        {
-            // Setup vars
-            uint32_t bsize  = cd->nSectorsToRead;
-            uint64_t offset = uint64_t(cd->nSectorOffset)  << 11;   // translate 2KiB based offset to actual offset
-            uint32_t size   = uint32_t(bsize) << 11;                // translate 2KiB based size to actual size
-            HANDLE hFile    = (HANDLE) cd->hFile;
-            bool bResult    = false;
-            const char* filename = nullptr; int index = -1; // When abstract those fields are valid
-            
-            // Try to find abstract file from hFile
-            if(true)
-            {
-                scoped_lock xlock(streaming->cs);
-                auto it = std::find(streaming->stm_files.begin(), streaming->stm_files.end(), hFile);
-                if(it != streaming->stm_files.end())
-                {
-                    bIsAbstract = true;
-                    
-                    // Setup vars based on abstract file
-                    sfile  = &(*it);
-                    offset = 0;
-                    size   = (uint32_t) sfile->info.file->size;
-                    bsize  = GetSizeInBlocks(size);
-                    index  = sfile->index;
-                    filename = sfile->info.file->filepath();
-                }
-            }
-            
-#if !defined(NDEBUG) && 0
-            plugin_ptr->Log("$$$$$$$$$ CdStreamThread streaming (%u) model %u offset %llu size %u", bIsAbstract,   
-                                                                                ReadMemory<uint32_t>(raw_ptr(0x8E4A60 + (i * 38 * 4)/*(i * 0xB480)*/)),
-                                                                                offset, size);                                                       
-#endif
-
-            // Setup overlapped structure
-            LARGE_INTEGER offset_li;
-            DWORD nBytesReaden;
-            offset_li.QuadPart        = offset;
-            cd->overlapped.Offset     = offset_li.LowPart;
-            cd->overlapped.OffsetHigh = offset_li.HighPart;
-            
-            // Read the stream
-            if(ReadFile(hFile, cd->lpBuffer, size, &nBytesReaden, &cd->overlapped))
-            {
-                bResult = true;
-            }
-            else
-            {
-                if(GetLastError() == ERROR_IO_PENDING)
-                {
-                    // This happens when the stream was open for async operations, let's wait until everything has been read
-                    // As noted on MSDN [http://msdn.microsoft.com/en-us/library/windows/desktop/aa363858(v=vs.85).aspx], when
-                    // you open a stream with FILE_FLAG_NO_BUFFERING  (R* does that with their cd streams) it gives you maximum
-                    // performance if you use overlapped I/O
-                    bResult = GetOverlappedResult(hFile, &cd->overlapped, &nBytesReaden, true) != 0;
-                }
-            }
-            
-            // There's some real problem if we can't load a abstract model
-            if(bIsAbstract && !bResult)
-                plugin_ptr->Log("Warning: Failed to load abstract model file %s; error code: 0x%X", filename, GetLastError());
-            
 
-            // Set the cdstream status, 0 for "okay" and 254 for "failed to read"
-            cd->status = bResult? 0 : 254;
-        }
-        
-        // Remove from the queue what we just readed
-        RemoveFirstInQueue(pQueue);
-        
-        // Cleanup
-        if(bIsAbstract) streaming->CloseModel(sfile);
-        cd->nSectorsToRead = 0;
-        if(cd->bLocked) ReleaseSemaphore(cd->semaphore, 1, 0);
-        cd->bInUse = false;
+        scheduler.Process(i, [pQueue] { RemoveFirstInQueue(pQueue); });
     }
     return 0;
 }
@@ -288,11 +384,11 @@ HANDLE CAbstractStreaming::TryOpenAbstractHandle(int index, HANDLE hFile)
     
     // Try to find the object index in the import list
     auto it = streaming->imports.find(index);
-    if(it != streaming->imports.end())
+    if(it != nullptr)
     {
          // Don't use our custom model if we're falling back to the original file because of an error
-        if(it->second.isFallingBack == false)
-            f = streaming->OpenModel(it->second, it->first);
+        if(it->isFallingBack == false)
+            f = streaming->OpenModel(*it, index);
     }
     
     // Returns the file from the abstract streaming if available
@@ -306,9 +402,32 @@ HANDLE CAbstractStreaming::TryOpenAbstractHandle(int index, HANDLE hFile)
 auto CAbstractStreaming::OpenModel(ModelInfo& file, int index) -> AbctFileHandle*
 {
     DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN | (*pStreamCreateFlags & FILE_FLAG_OVERLAPPED);
-    
-    HANDLE hFile = CreateFileA(file.file->fullpath(fbuffer).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
-                               OPEN_EXISTING, flags, NULL);
+    auto* packed = this->packed.Find(file.file);
+    HANDLE hFile;
+
+    if(true)
+    {
+        scoped_lock xlock(this->cs);
+        hFile = this->stm_handles.Take(index, file.file);
+    }
+
+    if(hFile == nullptr && packed)
+    {
+        // The model is in the packed archive, read it from there (or from its own file if that fails)
+        if((hFile = this->packed.Duplicate()) == nullptr)
+        {
+            this->packed.Forget(file.file);
+            packed = nullptr;
+        }
+    }
+
+    if(hFile == nullptr)
+    {
+        // The handle may be cached for a long time, so don't prevent the file from being changed meanwhile
+        hFile = CreateFileA(file.file->fullpath(fbuffer).c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                            OPEN_EXISTING, flags, NULL);
+    }
     
     if(hFile == INVALID_HANDLE_VALUE)
     {
@@ -316,10 +435,15 @@ auto CAbstractStreaming::OpenModel(ModelInfo& file, int index) -> AbctFileHandle
                        file.file->filepath(), GetLastError());
         return nullptr;
     }
+    else if(auto f = this->stm_files.Insert(hFile, file, index, packed? uint64_t(packed->offset) << 11 : 0))
+    {
+        return f;
+    }
     else
     {
-        scoped_lock xlock(this->cs);
-        return &(*this->stm_files.emplace(stm_files.end(), hFile, file, index));
+        plugin_ptr->Log("Warning: Too many open files for abstract streaming, failed to stream file \"%s\"", file.file->filepath());
+        CloseHandle(hFile);
+        return nullptr;
     }
 }
 
@@ -329,13 +453,44 @@ auto CAbstractStreaming::OpenModel(ModelInfo& file, int index) -> AbctFileHandle
  */
 void CAbstractStreaming::CloseModel(AbctFileHandle* file)
 {
+    HANDLE handle = file->handle;
+    id_t index = file->index;
+    auto* mfile = file->info->file;
+
+    // Remove this file from the open files table
+    this->stm_files.Erase(handle);
+
+    // Keep the file handle open for the next time this model gets streamed
     scoped_lock xlock(this->cs);
-    
-    // Close the file handle
-    CloseHandle(file->handle);
-    
-    // Remove this file from the open files list
-    this->stm_files.remove(*file);
+    this->stm_handles.Give(handle, index, mfile);
+}
+
+/*
+ *  CAbstractStreaming::ReadFromMemory
+ *      Copies the content of an abstract file into 'dest' if it's in memory (resident or prefetched), without touching the disk
+ */
+bool CAbstractStreaming::ReadFromMemory(AbctFileHandle* file, void* dest)
+{
+    if(true)
+    {
+        scoped_lock xlock(this->cs);
+        if(this->stm_resident.Serve(file->index, file->info->file, dest))
+            return true;
+    }
+    return this->prefetch.Serve(file->index, file->info->file, dest);
+}
+
+/*
+ *  CAbstractStreaming::KeepInMemory
+ *      Keeps a copy of an abstract file just read into 'src' for the next time it gets streamed, if it's small enough
+ */
+void CAbstractStreaming::KeepInMemory(AbctFileHandle* file, const void* src)
+{
+    if(AbctResidentCache::IsResidentFile(file->info->file))
+    {
+        scoped_lock xlock(this->cs);
+        this->stm_resident.Store(file->index, file->info->file, src);
+    }
 }
 
 /*
@@ -346,19 +501,340 @@ void CAbstractStreaming::CloseModel(AbctFileHandle* file)
 bool CAbstractStreaming::DoesModelNeedsFallback(id_t index)
 {
     auto it = imports.find(index);
-    if(it != imports.end())
+    if(it != nullptr)
     {
-        auto& m = it->second;
+        auto& m = *it;
         if(m.isFallingBack == false)    // If already falling back, don't check for file existence again
         {
+            BY_HANDLE_FILE_INFORMATION bhi;
+            WIN32_FILE_ATTRIBUTE_DATA fad;
+            bool packed = (this->packed.Find(m.file) != nullptr);
+            bool exists = false, same = false;
+
+            // The cached handle of a model is still open on its file, so check the file through it instead of looking up its path
+            // A deleted or replaced file has no links left while a handle keeps it alive, a new file may be at its path though
+            // The cached handle of a packed model is of the archive, so the file itself gets looked up
+            if(!packed)
+            {
+                scoped_lock xlock(this->cs);
+                if(this->stm_handles.Inspect(index, m.file, bhi))
+                {
+                    exists = (bhi.nNumberOfLinks != 0);
+                    same   = exists
+                           && m.file->size == uint64_t(GetLongFromLargeInteger(bhi.nFileSizeLow, bhi.nFileSizeHigh))
+                           && m.file->time == uint64_t(GetLongFromLargeInteger(bhi.ftLastWriteTime.dwLowDateTime, bhi.ftLastWriteTime.dwHighDateTime));
+                }
+            }
+
+            if(!same)
+            {
+                exists = !!GetFileAttributesExA(m.file->fullpath(fbuffer).c_str(), GetFileExInfoStandard, &fad);
+                same   = exists
+                       && m.file->size == uint64_t(GetLongFromLargeInteger(fad.nFileSizeLow, fad.nFileSizeHigh))
+                       && m.file->time == uint64_t(GetLongFromLargeInteger(fad.ftLastWriteTime.dwLowDateTime, fad.ftLastWriteTime.dwHighDateTime));
+            }
+
+            // A packed model is read from the archive only while its file is still the one that got packed, otherwise
+            // it has been changed or removed outside of a refresh and gets read from its own file (or falls back) again
+            if(packed)
+            {
+                if(same) return false;
+                this->InvalidateHandles(m.file);
+            }
+            else if(!same)
+            {
+                // Same for cached handles and copies, they may be of a file since replaced or removed
+                scoped_lock xlock(this->cs);
+                this->stm_handles.Invalidate(m.file);
+                this->stm_resident.Invalidate(m.file);
+            }
+
             // If file isn't on disk we should fall back to the stock model
-            if(!IsPath(m.file->fullpath(fbuffer).c_str()))
+            if(!exists)
                 return true;
         }
     }
     return false;
 }
 
+/*
+ *  CAbstractStreaming::PrefetchAfter
+ *      Tells the prefetcher the specified model is about to be read, so it learns and prefetches what usually comes next
+ */
+void CAbstractStreaming::PrefetchAfter(id_t index)
+{
+    this->prefetch.OnRequest(index, [this](id_t id) -> const modloader::file*
+    {
+        // Only abstract files which aren't loaded or about to be, nor in memory already
+        auto it = this->imports.find(id);
+        if(it != nullptr && !it->isFallingBack && !this->IsModelOnStreaming(id))
+        {
+            scoped_lock xlock(this->cs);
+            if(!this->stm_resident.Contains(id, it->file))
+                return it->file;
+        }
+        return nullptr;
+    });
+}
+
+
+/*
+ *  CAbstractStreaming::AbctFileTable
+ *      Insert claims slots going through the busy key, so lookups never see a partially filled slot.
+ *      Erased slots can't be emptied right away since they may be in the middle of the lookup path of another file, so Insert
+ *      empties them all at once when there's no file open (it's called from the game thread only, nobody else would fill them).
+ */
+auto CAbstractStreaming::AbctFileTable::Insert(HANDLE handle, ModelInfo& info, id_t index, uint64_t offset) -> AbctFileHandle*
+{
+    if(count.load(std::memory_order_acquire) == 0)
+    {
+        for(auto& s : slots)
+        {
+            HANDLE key = erased_key();
+            s.key.compare_exchange_strong(key, empty_key(), std::memory_order_relaxed);
+        }
+    }
+
+    for(size_t i = 0, h = Hash(handle); i < capacity; ++i, h = (h + 1) & (capacity - 1))
+    {
+        auto& s = slots[h];
+        HANDLE key = s.key.load(std::memory_order_relaxed);
+        if((key == empty_key() || key == erased_key())
+        && s.key.compare_exchange_strong(key, busy_key(), std::memory_order_acquire))
+        {
+            s.file = AbctFileHandle(handle, info, index, offset);
+            count.fetch_add(1, std::memory_order_relaxed);
+            s.key.store(handle, std::memory_order_release);
+            return &s.file;
+        }
+    }
+    return nullptr;
+}
+
+auto CAbstractStreaming::AbctFileTable::Find(HANDLE handle) -> AbctFileHandle*
+{
+    if(auto s = FindSlot(handle))
+        return &s->file;
+    return nullptr;
+}
+
+void CAbstractStreaming::AbctFileTable::Erase(HANDLE handle)
+{
+    if(auto s = FindSlot(handle))
+    {
+        s->key.store(erased_key(), std::memory_order_relaxed);
+        count.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+auto CAbstractStreaming::AbctFileTable::FindSlot(HANDLE handle) -> slot*
+{
+    for(size_t i = 0, h = Hash(handle); i < capacity; ++i, h = (h + 1) & (capacity - 1))
+    {
+        auto& s = slots[h];
+        HANDLE key = s.key.load(std::memory_order_acquire);
+        if(key == handle)
+            return &s;
+        else if(key == empty_key())
+            break;
+    }
+    return nullptr;
+}
+
+
+/*
+ *  CAbstractStreaming::AbctHandleCache
+ *      The cache is small, so a linear search over it is cheaper than keeping any lookup structure
+ */
+HANDLE CAbstractStreaming::AbctHandleCache::Take(id_t index, const modloader::file* file)
+{
+    for(auto& e : entries)
+    {
+        if(e.handle && e.index == index && e.file == file)
+        {
+            HANDLE handle = e.handle;
+            e = entry();
+            ++hits;
+            return handle;
+        }
+    }
+    ++misses;
+    return nullptr;
+}
+
+void CAbstractStreaming::AbctHandleCache::Give(HANDLE handle, id_t index, const modloader::file* file)
+{
+    entry* slot = nullptr;
+    for(auto& e : entries)
+    {
+        if(e.handle == nullptr)
+        {
+            slot = &e;  // free slot
+            break;
+        }
+        else if(slot == nullptr || e.tick < slot->tick)
+            slot = &e;  // least recently used so far
+    }
+
+    if(slot->handle)
+    {
+        CloseHandle(slot->handle);
+        ++evictions;
+    }
+
+    slot->handle = handle;
+    slot->file   = file;
+    slot->index  = index;
+    slot->tick   = ++tick;
+}
+
+bool CAbstractStreaming::AbctHandleCache::Inspect(id_t index, const modloader::file* file, BY_HANDLE_FILE_INFORMATION& info) const
+{
+    for(auto& e : entries)
+    {
+        if(e.handle && e.index == index && e.file == file)
+            return !!GetFileInformationByHandle(e.handle, &info);
+    }
+    return false;
+}
+
+void CAbstractStreaming::AbctHandleCache::Invalidate(const modloader::file* file)
+{
+    for(auto& e : entries)
+    {
+        if(e.handle && e.file == file)
+        {
+            CloseHandle(e.handle);
+            e = entry();
+        }
+    }
+}
+
+void CAbstractStreaming::AbctHandleCache::Clear()
+{
+    for(auto& e : entries)
+    {
+        if(e.handle) CloseHandle(e.handle);
+        e = entry();
+    }
+}
+
+
+/*
+ *  CAbstractStreaming::AbctResidentCache
+ *      Copies are allocated one after the other in the current chunk and never moved, except when the budget is reached
+ *      and enough dropped copies can be reclaimed by compacting all the chunks
+ */
+bool CAbstractStreaming::AbctResidentCache::IsResidentFile(const modloader::file* file)
+{
+    switch(GetResType(*file))
+    {
+        case ResType::Model:
+        case ResType::TexDictionary:
+        case ResType::Collision:
+            return file->size != 0 && file->size <= max_file_size;
+    }
+    return false;
+}
+
+bool CAbstractStreaming::AbctResidentCache::Serve(id_t index, const modloader::file* file, void* dest)
+{
+    auto it = entries.find(index);
+    if(it != entries.end() && it->second.file == file)
+    {
+        std::memcpy(dest, &chunks[it->second.chunk][it->second.offset], (size_t)(file->size));
+        ++hits;
+        return true;
+    }
+    return false;
+}
+
+void CAbstractStreaming::AbctResidentCache::Store(id_t index, const modloader::file* file, const void* src)
+{
+    if(!IsResidentFile(file) || Contains(index, file))
+        return;
+
+    // Another file at this index (it has been reimported)
+    auto it = entries.find(index);
+    if(it != entries.end())
+    {
+        dead += it->second.size;
+        entries.erase(it);
+    }
+
+    auto size = (uint32_t)((file->size + 15) & ~uint64_t(15));
+    if(chunk_used + size > chunk_size)
+    {
+        // Reclaim dropped copies when there's no room for another chunk
+        if(Capacity() + chunk_size > memory_budget && dead > memory_budget / 4)
+            Compact();
+
+        if(chunk_used + size > chunk_size)
+        {
+            if(Capacity() + chunk_size > memory_budget)
+                return;
+            chunks.emplace_back(new char[chunk_size]);
+            chunk_used = 0;
+        }
+    }
+
+    entry e = { file, uint32_t(chunks.size() - 1), uint32_t(chunk_used), size };
+    std::memcpy(&chunks[e.chunk][e.offset], src, (size_t)(file->size));
+    entries.emplace(index, e);
+    chunk_used += size;
+    ++stores;
+}
+
+bool CAbstractStreaming::AbctResidentCache::Contains(id_t index, const modloader::file* file) const
+{
+    auto it = entries.find(index);
+    return it != entries.end() && it->second.file == file;
+}
+
+void CAbstractStreaming::AbctResidentCache::Invalidate(const modloader::file* file)
+{
+    for(auto it = entries.begin(); it != entries.end(); )
+    {
+        if(it->second.file == file)
+        {
+            dead += it->second.size;
+            it = entries.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void CAbstractStreaming::AbctResidentCache::Clear()
+{
+    chunks.clear();
+    entries.clear();
+    chunk_used = chunk_size;
+    dead = 0;
+}
+
+void CAbstractStreaming::AbctResidentCache::Compact()
+{
+    std::vector<std::unique_ptr<char[]>> old_chunks;
+    old_chunks.swap(this->chunks);
+    this->chunk_used = chunk_size;
+    this->dead = 0;
+
+    for(auto& pair : entries)
+    {
+        auto& e = pair.second;
+        if(chunk_used + e.size > chunk_size)
+        {
+            chunks.emplace_back(new char[chunk_size]);
+            chunk_used = 0;
+        }
+        std::memcpy(&chunks.back()[chunk_used], &old_chunks[e.chunk][e.offset], e.size);
+        e.chunk  = uint32_t(chunks.size() - 1);
+        e.offset = uint32_t(chunk_used);
+        chunk_used += e.size;
+    }
+}
+
 
 /*
  *  CAbstractStreaming::BuildPrevOnCdMap
@@ -419,6 +895,7 @@ void CAbstractStreaming::Patch()
         // Do custom setup
         this->BuildClothesMap();                                // Find out clothing hashes and remove clothes from raw_models
         this->LoadAbstractCdDirectory(refs_mapped(raw_models)); // Load abstract directory, our custom files
+        this->prefetch.Startup([this](hash_t hash) { return this->FindModelFromHash(hash); });
 
         // Mark streaming as initialized
         this->bHasInitializedStreaming = true;
@@ -534,6 +1011,9 @@ void CAbstractStreaming::Patch()
                 this->RegisterStockEntry(strcat(entry.m_szFileName, ".dff"), entry, index, img_id);
             }
 
+            // The game has just given a (maybe different) tex dictionary to this special model
+            this->txd_assoc.Touch(index);
+
             // Try to find abstract special entry related to this request....
             // If it's possible, quickly import our entry into this special index
             // otherwise quickly remove our previous entry at this special index if any there
@@ -6,6 +6,7 @@
  */
 #include <stdinc.hpp>
 #include "streaming.hpp"
+#include <img_parser/img_parser.hpp>
 using namespace modloader;
 
 
@@ -199,23 +200,18 @@ void CAbstractStreaming::FetchCdDirectory(TempCdDir_t& cd_dir, const char*& file
     // Do actual work
     if(FILE* f = fopen(filename, "rb"))
     {
-        uint32_t count = -1;
-        DirectoryInfo entry;
-
-        auto& deque = cd_dir.emplace(cd_dir.end(), std::piecewise_construct, 
+        auto& entries = cd_dir.emplace(cd_dir.end(), std::piecewise_construct, 
                                         std::forward_as_tuple(id), std::forward_as_tuple())->second;
 
-        // The header is present only in SA IMG
-        if(gvm.IsSA())
-        {
-            fread(&count, sizeof(count), 1, f); // "VER2"
-            fread(&count, sizeof(count), 1, f); // actual file count
-        }
+        // The directory is in the IMG itself (VER2) only in SA, III and VC have .dir files
+        auto status = img::read(f, fread, gvm.IsSA()? img::version::v2 : img::version::v1, entries);
+        if(status != img::status::good)
+            plugin_ptr->Log("Warning: Cd directory \"%s\" is malformed (%s), using %u entries from it.",
+                            filename, img::to_string(status), uint32_t(entries.size()));
 
-        // Read entry by entry and push to @cd_dir deque
-        while(count-- && fread(&entry, sizeof(entry), 1, f))
+        if(gvm.IsSA())  // Only SA has two size fields
         {
-            if(gvm.IsSA())  // Only SA has two size fields
+            for(auto& entry : entries)
             {
                 if(entry.m_usCompressedSize__ != 0)
                 {
@@ -223,8 +219,6 @@ void CAbstractStreaming::FetchCdDirectory(TempCdDir_t& cd_dir, const char*& file
                     entry.m_usCompressedSize__ = 0;
                 }
             }
-
-            deque.emplace_back(entry);
         }
 
         fclose(f);
@@ -303,6 +297,8 @@ void CAbstractStreaming::LoadAbstractCdDirectory(ref_list<const modloader::file*
     // Streaming bus must be empty before this operation
     if(this->bHasInitializedStreaming)
         this->FlushChannels();
+    else
+        this->packed.Build(files);  // First load, pack the loose files (if there's enough of them)
 
     // Fill entry buffer and advance iterator
     auto ReadEntry = [&](DirectoryInfo& entry)
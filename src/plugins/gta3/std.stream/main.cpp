@@ -19,6 +19,7 @@ class ThePlugin : public modloader::basic_plugin
 {
     private:
         file_overrider ov_ped_ifp;
+        CIplProbe ipl_probe;
 
     public:
         const info& GetInfo();
@@ -85,6 +86,7 @@ bool ThePlugin::OnStartup()
  */
 bool ThePlugin::OnShutdown()
 {
+    ipl_probe.Save();
     if(streaming)
     {
         streaming->ShutRefreshInterface(); // TODO move to dtor?
@@ -144,18 +146,10 @@ int ThePlugin::GetBehaviour(modloader::file& file)
 
                 case ResType::StreamedScene:
                 {
-                    // Make sure this is a binary IPL by reading the file magic
-                    char buf[4];
-                    if(FILE* f = fopen(file.fullpath().c_str(), "rb"))
-                    {
-                        if(fread(buf, 4, 1, f) && !memcmp(buf, "bnry", 4))
-                        {
-                            fclose(f);
-                            break;
-                        }
-                        fclose(f);
-                    }
-                    return MODLOADER_BEHAVIOUR_NO;
+                    // Make sure this is a binary IPL by reading the file magic (or remembering it)
+                    if(!ipl_probe.IsBinary(file))
+                        return MODLOADER_BEHAVIOUR_NO;
+                    break;
                 }
 
                 case ResType::VehRecording:
@@ -219,6 +213,7 @@ bool ThePlugin::UninstallFile(const modloader::file& file)
 void ThePlugin::Update()
 {
     streaming->Update();
+    ipl_probe.Save();
 }
 
 
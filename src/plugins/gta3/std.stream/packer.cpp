@@ -0,0 +1,368 @@
+/*
+ * Standard Streamer Plugin for Mod Loader
+ * Copyright (C) 2014  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include <stdinc.hpp>
+#include "streaming.hpp"
+using namespace modloader;
+
+static const char*    packed_img_name    = "stream.img";        // Archive in the plugin cache directory
+static const char*    packed_idx_name    = "stream.img.idx";    // Information about the files in the archive
+static const uint32_t packed_idx_magic   = 0x4B504C4D;          // "MLPK"
+static const uint32_t packed_idx_version = 1;
+
+// Header of the archive index file, followed by the packed items
+struct PackedIdxHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;      // Number of directory entries reserved in the archive
+    uint32_t end;           // End of the archive (in 2KiB blocks)
+    uint32_t count;         // Number of items following this header
+};
+
+
+/*
+ *  CPackedImg::IsPackable
+ *      Only the files inside .img folders get packed, they're the ones that usually come by the thousands
+ */
+bool CPackedImg::IsPackable(const modloader::file& file)
+{
+    auto inFolder = GetPathComponentBack<char>(file.filedir(), 2);
+    return file.size != 0
+        && GetSizeInBlocks(file.size) <= 0xFFFF     // must fit in a directory entry
+        && GetFileExtension(inFolder) == "img";
+}
+
+// Work of the packing thread, it doesn't touch the modloader::file objects since those may go away meanwhile
+struct CPackedImg::Packing
+{
+    std::string              imgpath;
+    std::string              idxpath;
+    PackedIdxHeader          header;
+    bool                     rebuild;
+    std::vector<Item>        items;         // Files to be in the archive, the ones with a zero offset still need to be written
+    std::vector<std::string> paths;         // Full path of the loose file of each item
+    std::vector<std::string> names;         // Name of each item in the archive directory
+    std::atomic<bool>        cancel { false };  // Stop after the file being copied
+};
+
+
+/*
+ *  CPackedImg::CopyInto
+ *      Copies the content of a loose file into the archive at the specified offset (in blocks), padding it to the next block
+ */
+bool CPackedImg::CopyInto(FILE* archive, const std::string& fullpath, uint64_t size, uint32_t offset)
+{
+    static const size_t align = 2048;
+    bool result = false;
+
+    if(FILE* f = fopen(fullpath.c_str(), "rb"))
+    {
+        char buffer[16 * align];
+        uint64_t remaining = size;
+
+        if(!_fseeki64(archive, int64_t(offset) * align, SEEK_SET))
+        {
+            while(remaining)
+            {
+                auto count = (size_t)((std::min<uint64_t>)(remaining, sizeof(buffer)));
+                if(fread(buffer, 1, count, f) != count || fwrite(buffer, 1, count, archive) != count)
+                    break;
+                remaining -= count;
+            }
+
+            if(remaining == 0)
+            {
+                auto padding = size_t(GetSizeInBlocks(size) * align - size);
+                std::memset(buffer, 0, padding);
+                result = (fwrite(buffer, 1, padding, archive) == padding);
+            }
+        }
+
+        fclose(f);
+    }
+
+    return result;
+}
+
+/*
+ *  CPackedImg::Build
+ *      Serves the loose files among 'files' from the archive built in previous runs, and packs the ones it doesn't have yet
+ *      When most of the previous archive is still valid, only the changed files get written (at the end of the archive),
+ *      otherwise the archive is rebuilt from scratch, grouping files likely requested together (same folder and same name,
+ *      i.e. a vehicle model and its texture dictionary) next to each other.
+ *      The writing happens in the packing thread, so the files being written are streamed from their own file in this run.
+ */
+bool CPackedImg::Build(ref_list<const modloader::file*> files)
+{
+    std::vector<std::pair<std::string, const modloader::file*>> loose;  // <grouping key, file>
+
+    this->Close();
+
+    for(auto& ref : files)
+    {
+        auto* file = ref.get();
+        if(IsPackable(*file))
+        {
+            // Key is the folder, then the name without extension, then the extension
+            std::string key(file->filepath(), file->filename());
+            key.append(1, '\0').append(file->filename(), file->filext()).append(1, '\0').append(file->filext());
+            loose.emplace_back(std::move(tolower(key)), file);
+        }
+    }
+
+    if(loose.size() < min_files)
+        return false;
+
+    if(!this->initialized && !this->Startup(location::localappdata))
+    {
+        plugin_ptr->Log("Warning: Failed to setup cache directory for packing loose files.");
+        return false;
+    }
+
+    std::sort(loose.begin(), loose.end());
+
+    std::unique_ptr<Packing> packing(new Packing());
+    auto& imgpath = packing->imgpath = this->GetCachePath(std::string(packed_img_name));
+    auto& idxpath = packing->idxpath = this->GetCachePath(std::string(packed_idx_name));
+    auto& header  = packing->header;
+
+    // Load the information about the previous archive
+    std::map<uint32_t, Item> previous;
+    std::memset(&header, 0, sizeof(header));
+    if(FILE* f = fopen(idxpath.c_str(), "rb"))
+    {
+        Item item;
+        if(fread(&header, sizeof(header), 1, f) && header.magic == packed_idx_magic && header.version == packed_idx_version)
+        {
+            while(header.count-- && fread(&item, sizeof(item), 1, f))
+                previous.emplace(item.path_hash, item);
+        }
+        fclose(f);
+    }
+
+    // Find out which files are still fine in the previous archive
+    auto& packing_items = packing->items;
+    uint32_t reused_blocks = 0, changed_blocks = 0;
+    packing_items.reserve(loose.size());
+    for(auto& pair : loose)
+    {
+        auto* file = pair.second;
+        Item item = { uint32_t(modloader::hash(file->filepath())), 0, GetSizeInBlocks(file->size), 0, file->size, file->time };
+        auto it = previous.find(item.path_hash);
+        if(it != previous.end() && it->second.size == item.size && it->second.time == item.time)
+        {
+            item.offset = it->second.offset;
+            reused_blocks += item.blocks;
+        }
+        else
+            changed_blocks += item.blocks;
+        packing_items.emplace_back(item);
+    }
+
+    // Rebuild when the archive can't take the files or when it would end up with too much dead space
+    uint32_t data_start = GetSizeInBlocks(uint32_t(8 + header.capacity * sizeof(DirectoryInfo)));
+    uint32_t used_blocks = header.end > data_start? header.end - data_start : 0;
+    packing->rebuild = (header.magic != packed_idx_magic)
+                    || (loose.size() > header.capacity)
+                    || (reused_blocks > used_blocks)
+                    || ((used_blocks - reused_blocks) + changed_blocks > (used_blocks + changed_blocks) / 4)
+                    || !IsPathA(imgpath.c_str());
+
+    if(packing->rebuild)
+    {
+        header.capacity = uint32_t(loose.size() + loose.size() / 4 + 64);
+        header.end      = data_start = GetSizeInBlocks(uint32_t(8 + header.capacity * sizeof(DirectoryInfo)));
+        for(auto& item : packing_items) item.offset = 0;    // write everything again
+    }
+    else
+    {
+        // Serve the files still fine in the previous archive right away, the packing thread only appends to it.
+        // Sharing write access lets the packing thread open the archive while it's being streamed from.
+        DWORD flags = FILE_FLAG_RANDOM_ACCESS | (*pStreamCreateFlags & FILE_FLAG_OVERLAPPED);
+        this->hArchive = CreateFileA(imgpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, flags, NULL);
+        if(this->hArchive == INVALID_HANDLE_VALUE)
+        {
+            plugin_ptr->Log("Warning: Failed to open packed archive \"%s\"; error code: 0x%X", imgpath.c_str(), GetLastError());
+            this->hArchive = nullptr;
+        }
+        else
+        {
+            for(size_t i = 0; i < packing_items.size(); ++i)
+            {
+                if(packing_items[i].offset)
+                    this->items.emplace(loose[i].second, packing_items[i]);
+            }
+        }
+    }
+
+    uint32_t changed = uint32_t(std::count_if(packing_items.begin(), packing_items.end(), [](const Item& item) { return item.offset == 0; }));
+    plugin_ptr->Log("Streaming %u loose files from packed archive \"%s\", %u to be packed.",
+        uint32_t(this->items.size()), imgpath.c_str(), changed);
+
+    if(changed)
+    {
+        packing->paths.reserve(loose.size());
+        packing->names.reserve(loose.size());
+        for(auto& pair : loose)
+        {
+            packing->paths.emplace_back(pair.second->fullpath());
+            packing->names.emplace_back(pair.second->filename());
+        }
+
+        if(this->hThread = CreateThread(nullptr, 0, PackingThread, packing.get(), CREATE_SUSPENDED, nullptr))
+        {
+            // Packing is for the next runs, it should not take time from the game or the streaming
+            this->packing = packing.release();
+            SetThreadPriority(this->hThread, THREAD_PRIORITY_BELOW_NORMAL);
+            ResumeThread(this->hThread);
+        }
+        else
+            plugin_ptr->Log("Warning: Failed to create packing thread.");
+    }
+
+    return this->hArchive != nullptr;
+}
+
+/*
+ *  CPackedImg::Write
+ *      Writes the files which aren't in the archive yet, then the archive directory and index (called from the packing thread)
+ *      When cancelled, the archive is completed with the files written so far.
+ */
+bool CPackedImg::Write(Packing& packing)
+{
+    auto& header  = packing.header;
+    auto& items   = packing.items;
+    auto& imgpath = packing.imgpath;
+    auto& idxpath = packing.idxpath;
+    auto tmppath  = std::string(idxpath).append(".tmp");
+
+    // The previous index doesn't describe the archive anymore once it gets truncated
+    if(packing.rebuild)
+        DeleteFileA(idxpath.c_str());
+
+    FILE* archive = fopen(imgpath.c_str(), packing.rebuild? "wb" : "r+b");
+    if(archive == nullptr)
+    {
+        plugin_ptr->Log("Warning: Failed to open \"%s\" for packing loose files.", imgpath.c_str());
+        return false;
+    }
+
+    // Write the changed files at the end of the archive
+    uint32_t written = 0;
+    for(size_t i = 0; i < items.size() && !packing.cancel; ++i)
+    {
+        auto& item = items[i];
+        if(item.offset == 0)
+        {
+            if(CopyInto(archive, packing.paths[i], item.size, header.end))
+            {
+                item.offset = header.end;
+                header.end += item.blocks;
+                ++written;
+            }
+            else
+                plugin_ptr->Log("Warning: Failed to pack file \"%s\", it'll be streamed from its own file.", packing.paths[i].c_str());
+        }
+    }
+
+    // Write the archive directory, the files which failed to be packed are left out
+    std::vector<DirectoryInfo> entries;
+    entries.reserve(items.size());
+    for(size_t i = 0; i < items.size(); ++i)
+    {
+        if(items[i].offset)
+        {
+            entries.emplace_back();
+            FillDirectoryEntry(entries.back(), packing.names[i].c_str(), items[i].offset, items[i].size);
+        }
+    }
+
+    uint32_t count = uint32_t(entries.size());
+    bool success = !_fseeki64(archive, 0, SEEK_SET)
+                && fwrite("VER2", 4, 1, archive)
+                && fwrite(&count, sizeof(count), 1, archive)
+                && (entries.empty() || fwrite(entries.data(), sizeof(DirectoryInfo), entries.size(), archive) == entries.size());
+    success = !fclose(archive) && success;
+
+    // Save the archive index for the next run, replacing the previous one only once it's complete
+    if(success)
+    {
+        if(FILE* f = fopen(tmppath.c_str(), "wb"))
+        {
+            header.magic   = packed_idx_magic;
+            header.version = packed_idx_version;
+            header.count   = count;
+            success = !!fwrite(&header, sizeof(header), 1, f);
+            for(auto& item : items)
+            {
+                if(item.offset && success)
+                    success = !!fwrite(&item, sizeof(item), 1, f);
+            }
+            success = !fclose(f) && success;
+            success = success && MoveFileExA(tmppath.c_str(), idxpath.c_str(), MOVEFILE_REPLACE_EXISTING);
+        }
+        else
+            success = false;
+    }
+
+    if(!success)
+    {
+        plugin_ptr->Log("Warning: Failed to write packed archive \"%s\".", imgpath.c_str());
+        DeleteFileA(tmppath.c_str());
+        DeleteFileA(idxpath.c_str());
+        return false;
+    }
+
+    plugin_ptr->Log("Packed %u loose files into \"%s\" (%u written, %u reused)%s.",
+        count, imgpath.c_str(), written, count - written, packing.cancel? ", interrupted" : "");
+    return true;
+}
+
+/*
+ *  CPackedImg::PackingThread
+ *      Writes the files sent by Build
+ */
+DWORD __stdcall CPackedImg::PackingThread(void* param)
+{
+    return Write(*(Packing*)(param))? 0 : 1;
+}
+
+/*
+ *  CPackedImg::Close
+ *      Closes the archive, files will be streamed from their loose file again
+ */
+void CPackedImg::Close()
+{
+    if(this->hThread)
+    {
+        this->packing->cancel = true;
+        WaitForSingleObject(this->hThread, INFINITE);
+        CloseHandle(this->hThread);
+        delete this->packing;
+        this->hThread = nullptr;
+        this->packing = nullptr;
+    }
+
+    if(this->hArchive)
+    {
+        CloseHandle(this->hArchive);
+        this->hArchive = nullptr;
+    }
+    this->items.clear();
+}
+
+/*
+ *  CPackedImg::Duplicate
+ *      Gets a new handle to the archive, every open model needs its own handle (see AbctFileTable)
+ */
+HANDLE CPackedImg::Duplicate() const
+{
+    HANDLE hFile;
+    if(this->hArchive && DuplicateHandle(GetCurrentProcess(), this->hArchive, GetCurrentProcess(), &hFile, 0, FALSE, DUPLICATE_SAME_ACCESS))
+        return hFile;
+    return nullptr;
+}
@@ -0,0 +1,370 @@
+/*
+ * Standard Streamer Plugin for Mod Loader
+ * Copyright (C) 2014  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include <stdinc.hpp>
+#include "streaming.hpp"
+using namespace modloader;
+
+static const char*    prefetch_dat_name    = "prefetch.dat";    // What has been learned, in the plugin cache directory
+static const uint32_t prefetch_dat_magic   = 0x46504C4D;        // "MLPF"
+static const uint32_t prefetch_dat_version = 1;
+
+// Header of the learned data file, followed by the learned successors
+struct PrefetchDatHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;         // Number of records following this header
+};
+
+// A learned successor, resources are identified by their name hash since indices may change between runs
+struct PrefetchDatRecord
+{
+    uint32_t prev;
+    uint32_t next;
+    uint32_t count;
+};
+
+
+CPrefetcher::CPrefetcher()
+{
+    InitializeCriticalSection(&cs);
+}
+
+CPrefetcher::~CPrefetcher()
+{
+    this->StopThread();
+    DeleteCriticalSection(&cs);
+}
+
+/*
+ *  CPrefetcher::StopThread
+ *      Tells the reading thread to exit and waits for it, it exits after the file it's reading (if any)
+ */
+void CPrefetcher::StopThread()
+{
+    if(this->hThread)
+    {
+        if(true)
+        {
+            scoped_lock xlock(this->cs);
+            this->exiting = true;
+            this->jobs.clear();
+        }
+
+        ReleaseSemaphore(this->hSemaphore, 1, nullptr);
+        WaitForSingleObject(this->hThread, INFINITE);
+        CloseHandle(this->hThread);
+        CloseHandle(this->hSemaphore);
+        this->hThread = this->hSemaphore = nullptr;
+    }
+}
+
+/*
+ *  CPrefetcher::Startup
+ *      Loads what has been learned in previous runs and starts the reading thread
+ */
+void CPrefetcher::Startup(std::function<id_t(hash_t)> find_model)
+{
+    if(!this->initialized && !basic_cache::Startup(location::localappdata))
+    {
+        plugin_ptr->Log("Warning: Failed to setup cache directory for prefetching.");
+        return;
+    }
+
+    if(FILE* f = fopen(this->GetCachePath(std::string(prefetch_dat_name)).c_str(), "rb"))
+    {
+        PrefetchDatHeader header;
+        PrefetchDatRecord record;
+        if(fread(&header, sizeof(header), 1, f) && header.magic == prefetch_dat_magic && header.version == prefetch_dat_version)
+        {
+            while(header.count-- && fread(&record, sizeof(record), 1, f))
+            {
+                // Resources which are gone since the last run are forgotten
+                id_t prev = find_model(record.prev), next = find_model(record.next);
+                if(prev != -1 && next != -1 && prev != next && record.count)
+                    this->Learn(prev, next, record.count);
+            }
+        }
+        fclose(f);
+    }
+
+    if(this->hSemaphore = CreateSemaphoreA(nullptr, 0, 0x7FFFFFFF, nullptr))
+    {
+        if(this->hThread = CreateThread(nullptr, 0, ReadingThread, this, CREATE_SUSPENDED, nullptr))
+        {
+            // Prefetching should not take time from the game or the streaming
+            SetThreadPriority(this->hThread, THREAD_PRIORITY_BELOW_NORMAL);
+            ResumeThread(this->hThread);
+        }
+        else
+        {
+            CloseHandle(this->hSemaphore);
+            this->hSemaphore = nullptr;
+        }
+    }
+
+    if(this->hThread == nullptr)
+        plugin_ptr->Log("Warning: Failed to create prefetching thread.");
+}
+
+/*
+ *  CPrefetcher::Shutdown
+ *      Stops the reading thread and saves what has been learned
+ */
+void CPrefetcher::Shutdown(std::function<std::pair<hash_t, bool>(id_t)> find_hash)
+{
+    this->StopThread();
+
+    if(!this->initialized)
+        return;
+
+    plugin_ptr->Log("Prefetcher: %u hits, %u misses, %u wasted.", hits, misses, wasted);
+
+    std::vector<PrefetchDatRecord> records;
+    for(auto& pair : this->table)
+    {
+        auto prev = find_hash(pair.first);
+        for(auto& s : pair.second)
+        {
+            auto next = find_hash(s.id);
+            if(s.count && prev.second && next.second)
+                records.push_back(PrefetchDatRecord { prev.first, next.first, s.count });
+        }
+    }
+
+    auto path = this->GetCachePath(std::string(prefetch_dat_name));
+    bool success = false;
+    if(FILE* f = fopen(path.c_str(), "wb"))
+    {
+        PrefetchDatHeader header = { prefetch_dat_magic, prefetch_dat_version, uint32_t(records.size()) };
+        success = fwrite(&header, sizeof(header), 1, f)
+               && (records.empty() || fwrite(records.data(), sizeof(PrefetchDatRecord), records.size(), f) == records.size());
+        success = !fclose(f) && success;
+    }
+
+    if(!success)
+    {
+        plugin_ptr->Log("Warning: Failed to save prefetching data to \"%s\".", path.c_str());
+        DeleteFileA(path.c_str());
+    }
+}
+
+/*
+ *  CPrefetcher::Learn
+ *      Learns that 'next' has been requested right after 'prev' ('count' times)
+ */
+void CPrefetcher::Learn(id_t prev, id_t next, uint32_t count)
+{
+    auto& successors = this->table[prev];
+    successor* slot = &successors[0];
+
+    for(auto& s : successors)
+    {
+        if(s.count && s.id == next)
+        {
+            // Keep room to learn, older knowledge weights less
+            if((s.count += count) >= 0xFFFF)
+            {
+                for(auto& o : successors) o.count /= 2;
+            }
+            return;
+        }
+        if(s.count < slot->count)
+            slot = &s;
+    }
+
+    // Replace the least seen successor
+    slot->id    = next;
+    slot->count = (std::min<uint32_t>)(count, 0xFFFF);
+}
+
+/*
+ *  CPrefetcher::OnRequest
+ *      Learns from a resource request and prefetches the resources likely requested next
+ */
+void CPrefetcher::OnRequest(id_t id, std::function<const modloader::file*(id_t)> prefetchable)
+{
+    if(this->hThread == nullptr)
+        return;
+
+    if(this->last != -1 && this->last != id)
+        this->Learn(this->last, id);
+    this->last = id;
+
+    auto it = this->table.find(id);
+    if(it != table.end())
+    {
+        uint32_t total = 0;
+        for(auto& s : it->second) total += s.count;
+
+        for(auto& s : it->second)
+        {
+            // Only successors seen often enough to be worth the disk and memory
+            if(s.count >= min_count && s.count * 4 >= total)
+            {
+                if(auto* file = prefetchable(s.id))
+                    this->Enqueue(s.id, file);
+            }
+        }
+    }
+}
+
+/*
+ *  CPrefetcher::Enqueue
+ *      Sends the file at the specified index to the reading thread
+ */
+void CPrefetcher::Enqueue(id_t id, const modloader::file* file)
+{
+    if(file->size == 0 || file->size > max_file_size)
+        return;
+
+    scoped_lock xlock(this->cs);
+
+    if(this->buffers.count(id)) return;
+    for(auto& j : this->jobs)
+    {
+        if(j.id == id) return;
+    }
+
+    // Old predictions are less likely to be right
+    if(this->jobs.size() >= max_jobs)
+        this->jobs.pop_front();
+
+    this->jobs.push_back(job { id, file, file->fullpath(), file->size, this->generation });
+    ReleaseSemaphore(this->hSemaphore, 1, nullptr);
+}
+
+/*
+ *  CPrefetcher::Insert
+ *      Stores the content of a file read by the reading thread, dropping the oldest prefetched files to stay in budget
+ */
+void CPrefetcher::Insert(job& j, std::vector<char>&& data)
+{
+    scoped_lock xlock(this->cs);
+
+    // The file has changed while it was being read, or has been read twice
+    if(j.generation != this->generation || this->buffers.count(j.id))
+        return;
+
+    while(this->used + data.size() > memory_budget && !this->order.empty())
+    {
+        ++this->wasted;
+        this->Drop(this->buffers.find(this->order.front()));
+    }
+
+    this->used += data.size();
+    this->order.push_back(j.id);
+    this->buffers[j.id] = buffer { j.file, std::move(data) };
+}
+
+/*
+ *  CPrefetcher::Drop
+ *      Removes a prefetched file, returning its content (call inside the critical section)
+ */
+std::vector<char> CPrefetcher::Drop(std::map<id_t, buffer>::iterator it)
+{
+    std::vector<char> data = std::move(it->second.data);
+    this->used -= data.size();
+    this->order.erase(std::find(this->order.begin(), this->order.end(), it->first));
+    this->buffers.erase(it);
+    return data;
+}
+
+/*
+ *  CPrefetcher::Serve
+ *      Copies the prefetched content of the file at the specified index into 'dest' (called from the streaming threads)
+ */
+bool CPrefetcher::Serve(id_t id, const modloader::file* file, void* dest)
+{
+    std::vector<char> data;
+
+    if(true)
+    {
+        scoped_lock xlock(this->cs);
+        auto it = this->buffers.find(id);
+        if(it == buffers.end())
+        {
+            // Only a miss if it has been predicted, but it's still waiting to be read or being read
+            auto queued = std::find_if(jobs.begin(), jobs.end(), [id](const job& j) { return j.id == id; });
+            if(queued != jobs.end())
+            {
+                this->jobs.erase(queued);   // read by the streaming now
+                ++this->misses;
+            }
+            else if(this->reading == id)
+                ++this->misses;
+            return false;
+        }
+        else if(it->second.file != file || it->second.data.size() != file->size)
+        {
+            this->Drop(it);
+            ++this->misses;
+            return false;
+        }
+
+        // Take the content out so the copy happens outside the lock
+        data = this->Drop(it);
+        ++this->hits;
+    }
+
+    std::memcpy(dest, data.data(), data.size());
+    return true;
+}
+
+/*
+ *  CPrefetcher::Forget
+ *      Drops the prefetched content of the specified file
+ */
+void CPrefetcher::Forget(const modloader::file* file)
+{
+    scoped_lock xlock(this->cs);
+
+    ++this->generation;
+    this->jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [file](const job& j) { return j.file == file; }), jobs.end());
+
+    for(auto it = buffers.begin(); it != buffers.end(); )
+    {
+        if(it->second.file == file)
+            this->Drop(it++);
+        else
+            ++it;
+    }
+}
+
+/*
+ *  CPrefetcher::ReadingThread
+ *      Reads the files sent by Enqueue
+ */
+DWORD __stdcall CPrefetcher::ReadingThread(void* param)
+{
+    CPrefetcher& self = *(CPrefetcher*)(param);
+    while(true)
+    {
+        WaitForSingleObject(self.hSemaphore, -1);
+
+        job j;
+        if(true)
+        {
+            scoped_lock xlock(self.cs);
+            self.reading = -1;
+            if(self.exiting) break;
+            if(self.jobs.empty()) continue;     // the job has been dropped
+            j = std::move(self.jobs.front());
+            self.jobs.pop_front();
+            self.reading = j.id;
+        }
+
+        if(FILE* f = fopen(j.path.c_str(), "rb"))
+        {
+            std::vector<char> data((size_t)(j.size));
+            if(fread(data.data(), 1, data.size(), f) == data.size())
+                self.Insert(j, std::move(data));
+            fclose(f);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * Standard Streamer Plugin for Mod Loader
+ * Copyright (C) 2014  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include <stdinc.hpp>
+#include <thread>
+#include <system_error>
+#include "streaming.hpp"
+using namespace modloader;
+
+static const char*    probe_dat_name    = "iplprobe.dat";   // Peeked files, in the plugin cache directory
+static const uint32_t probe_dat_magic   = 0x50494C4D;       // "MLIP"
+static const uint32_t probe_dat_version = 1;
+
+// Header of the peeked files data, followed by the items
+struct ProbeDatHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;         // Number of items following this header
+};
+
+// Hash of a path relative to the game dir
+static uint32_t PathHash(const char* path)
+{
+    return modloader::hash(path, ::tolower);
+}
+
+
+/*
+ *  CIplProbe::IsBinary
+ *      Checks whether the specified .ipl file is a binary IPL, opening it only if it has changed since last peeked
+ */
+bool CIplProbe::IsBinary(const modloader::file& file)
+{
+    if(!this->initialized)
+        this->Load();
+
+    // Too small to have the magic
+    if(file.size < 4)
+        return false;
+
+    auto find = [&]() -> const Item*
+    {
+        auto it = this->items.find(PathHash(file.filepath()));
+        if(it != items.end() && it->second.size == file.size && it->second.time == file.time)
+            return &it->second;
+        return nullptr;
+    };
+
+    const Item* item = find();
+    if(item)
+        ++this->hits;
+    else
+    {
+        this->PeekFolder(file);
+        if((item = find()) == nullptr)
+        {
+            // The folder listing didn't catch it (e.g. the file has just been written), peek it alone
+            Item& peeked = this->items[PathHash(file.filepath())];
+            peeked = Item { PathHash(file.filepath()), {}, file.size, file.time };
+            Peek(file.fullpath(), peeked.magic);
+            item = &peeked;
+            ++this->peeks;
+            this->dirty = true;
+        }
+    }
+
+    return !memcmp(item->magic, "bnry", 4);
+}
+
+/*
+ *  CIplProbe::PeekFolder
+ *      Peeks all the .ipl files in the folder of the specified file which aren't known yet, in a few threads
+ */
+void CIplProbe::PeekFolder(const modloader::file& file)
+{
+    std::string folder(file.filepath(), file.filename());   // relative to the game dir, with a trailing slash
+
+    // Only once per folder, any file unknown after that is new and peeked alone
+    if(!this->folders.emplace(PathHash(folder.c_str())).second)
+        return;
+
+    std::vector<Item> peeking;
+    std::vector<std::string> paths;
+    auto fullfolder = std::string(plugin_ptr->loader->gamepath).append(folder);
+
+    WIN32_FIND_DATAA fd;
+    HANDLE hFind = FindFirstFileA(std::string(fullfolder).append("*.ipl").c_str(), &fd);
+    if(hFind != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if(!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                auto path = std::string(folder).append(fd.cFileName);
+                Item item = { PathHash(path.c_str()), {},
+                              uint64_t(GetLongFromLargeInteger(fd.nFileSizeLow, fd.nFileSizeHigh)),
+                              uint64_t(GetLongFromLargeInteger(fd.ftLastWriteTime.dwLowDateTime, fd.ftLastWriteTime.dwHighDateTime)) };
+
+                auto it = this->items.find(item.path_hash);
+                if(item.size >= 4 && (it == items.end() || it->second.size != item.size || it->second.time != item.time))
+                {
+                    peeking.emplace_back(item);
+                    paths.emplace_back(std::string(fullfolder).append(fd.cFileName));
+                }
+            }
+        }
+        while(FindNextFileA(hFind, &fd));
+        FindClose(hFind);
+    }
+
+    if(peeking.empty())
+        return;
+
+    // Each thread peeks a contiguous block of the files, the calling thread takes the first block
+    auto nthreads = (std::min)(size_t(max_threads), (peeking.size() + min_per_thread - 1) / min_per_thread);
+    auto run_block = [&](size_t b)
+    {
+        for(size_t i = peeking.size() * b / nthreads, end = peeking.size() * (b + 1) / nthreads; i < end; ++i)
+            Peek(paths[i], peeking[i].magic);
+    };
+
+    std::vector<std::thread> workers;
+    size_t b = 1;
+    try
+    {
+        for(; b < nthreads; ++b)
+            workers.emplace_back(run_block, b);
+    }
+    catch(const std::system_error&)
+    {
+        // Out of threads, the blocks left run here
+    }
+
+    run_block(0);
+    for(; b < nthreads; ++b) run_block(b);
+    for(auto& worker : workers) worker.join();
+
+    for(auto& item : peeking)
+        this->items[item.path_hash] = item;
+
+    this->peeks += uint32_t(peeking.size());
+    this->dirty = true;
+}
+
+/*
+ *  CIplProbe::Peek
+ *      Reads the magic of the specified file, zeroed if it couldn't be read
+ */
+void CIplProbe::Peek(const std::string& fullpath, char (&magic)[4])
+{
+    std::memset(magic, 0, sizeof(magic));
+    if(FILE* f = fopen(fullpath.c_str(), "rb"))
+    {
+        if(!fread(magic, sizeof(magic), 1, f))
+            std::memset(magic, 0, sizeof(magic));
+        fclose(f);
+    }
+}
+
+/*
+ *  CIplProbe::Load
+ *      Loads the files peeked in previous runs
+ */
+void CIplProbe::Load()
+{
+    if(!this->Startup(location::localappdata))
+    {
+        plugin_ptr->Log("Warning: Failed to setup cache directory for peeking .ipl files.");
+        this->initialized = true;   // don't try again, work without the cache
+        return;
+    }
+
+    if(FILE* f = fopen(this->GetCachePath(std::string(probe_dat_name)).c_str(), "rb"))
+    {
+        ProbeDatHeader header;
+        Item item;
+        if(fread(&header, sizeof(header), 1, f) && header.magic == probe_dat_magic && header.version == probe_dat_version)
+        {
+            while(header.count-- && fread(&item, sizeof(item), 1, f))
+                this->items.emplace(item.path_hash, item);
+        }
+        fclose(f);
+    }
+}
+
+/*
+ *  CIplProbe::Save
+ *      Saves the peeked files for the next run
+ */
+void CIplProbe::Save()
+{
+    if(!this->dirty || this->GetCachePath().empty())
+        return;
+
+    plugin_ptr->Log("Peeked .ipl files: %u known, %u opened.", hits, peeks);
+
+    auto path = this->GetCachePath(std::string(probe_dat_name));
+    bool success = false;
+    if(FILE* f = fopen(path.c_str(), "wb"))
+    {
+        ProbeDatHeader header = { probe_dat_magic, probe_dat_version, uint32_t(items.size()) };
+        success = !!fwrite(&header, sizeof(header), 1, f);
+        for(auto& pair : this->items)
+        {
+            if(success) success = !!fwrite(&pair.second, sizeof(pair.second), 1, f);
+        }
+        success = !fclose(f) && success;
+    }
+
+    if(!success)
+    {
+        plugin_ptr->Log("Warning: Failed to save peeked .ipl files to \"%s\".", path.c_str());
+        DeleteFileA(path.c_str());
+    }
+
+    this->dirty = false;
+}
@@ -24,7 +24,7 @@ struct tag_ped_t {} tag_ped;
  *      Refreshes the streaming, essentially refresh models that have been added, modified or deleted on Mod Loader.
  */
 template<class T>   // T = Traits (see traits/gta3)
-class Refresher : public IStreamRefresher, private T
+class Refresher : public IStreamRefresher2, private T
 {
     public:
         // To run the refresher, just construct it passing the streaming as argument
@@ -39,10 +39,13 @@ class Refresher : public IStreamRefresher, private T
         using T::GetEntityRwObject;
         using T::GetPedTaskManager;
         using T::GetVehicleType;
+        using T::GetModelInfo;
+        using T::GetModelType;
         using typename T::PedPool_t;
         using typename T::VehiclePool_t;
         using typename T::BuildingPool_t;
         using typename T::ObjectPool_t;
+        using typename T::ModelType;
 
 
         using hash_t        = CAbstractStreaming::hash_t;
@@ -81,7 +84,6 @@ class Refresher : public IStreamRefresher, private T
 
         // Association maps
         std::map<id_t, std::vector<void*>>  mEntityAssoc;   // Map of association between a model id and many game entities
-        std::map<id_t,  std::vector<id_t>>  mTxdAssoc;      // Map of association between a txd and many dffs
         std::map<EntityType, EntityEvent>   mEntityEvents;  // Map of association between type of entities and their refreshing events
         std::map<id_t, RefreshInfo>         mToRefresh;     // List of resources that needs to be refreshed (dff/txd/col/ifp/ipl/etc)
 
@@ -92,8 +94,9 @@ class Refresher : public IStreamRefresher, private T
         void Release() override;
         void Clear() override;
 
-        // Initialization
+        // Tex dictionary association (kept by the streaming between refreshes)
         void RebuildTxdAssociationMap() override;
+        void UpdateTxdAssociation(uint32_t id) override;
 
         // Actual refreshing
         void DestroyEntities() override;
@@ -136,7 +139,6 @@ class Refresher : public IStreamRefresher, private T
     private:
 
         // Returns an vector of models that uses the specified txd index (starts from 0)
-        // This should be ran only after the txd association map is already built
         const std::vector<id_t>& GetModelsUsingTxdIndex(id_t index);
 
         // Adds entities from the pool at @addr where the type of pool is @PoolType into the entities association map
@@ -247,7 +249,6 @@ Refresher<T>::Refresher(CAbstractStreaming& s, uint32_t capabilities)
 {
     this->mRefreshRequests.reserve(256);
     this->SetupEntityEvents();
-    this->RebuildTxdAssociationMap();
 }
 
 /*
@@ -297,7 +298,24 @@ template<class T> void Refresher<T>::PrepareRefresh()
  */
 template<class T> auto Refresher<T>::GetModelsUsingTxdIndex(id_t index) -> const std::vector<id_t>&
 {
-    return this->mTxdAssoc[index];
+    auto& assoc = streaming.txd_assoc;
+
+    // Built on the first refresh that needs it, then kept up to date by the calls telling about txd changes
+    if(!assoc.built)
+        this->RebuildTxdAssociationMap();
+    else
+    {
+        // The special models get their txd from the game on each request, without any call telling about it
+        for(auto id : assoc.TakeTouched())
+            this->UpdateTxdAssociation(id);
+
+        // Any other change nobody told about is caught by checking the models in the list, and the map is built again
+        auto& models = assoc.ModelsUsing(index);
+        if(std::any_of(models.begin(), models.end(), [&](id_t id) { return this->GetModelTxdIndex(id) != index; }))
+            this->RebuildTxdAssociationMap();
+    }
+
+    return assoc.ModelsUsing(index);
 }
 
 
@@ -306,21 +324,53 @@ template<class T> auto Refresher<T>::GetModelsUsingTxdIndex(id_t index) -> const
 
 /*
  *  Refresher::RebuildTxdAssociationMap
- *      Builds an association map of txd vs. dff for fast lookup
+ *      Brings the association map of txd vs. dff up to date with all the models (only the changed models are touched)
  */
 template<class T> void Refresher<T>::RebuildTxdAssociationMap()
 {
-    if(this->capabilities & STREAMREFRESHER_CAPABILITY_TEXDICT) // only needed if refreshing texdictionaries
+    for(auto i = 0u; i < this->max_models; ++i)
+        streaming.txd_assoc.Set(i, this->GetModelTxdIndex(i));
+    streaming.txd_assoc.built = true;
+}
+
+/*
+ *  Refresher::UpdateTxdAssociation
+ *      Brings the association map of txd vs. dff up to date with the specified model, whose txd has changed
+ */
+template<class T> void Refresher<T>::UpdateTxdAssociation(uint32_t id)
+{
+    if(streaming.txd_assoc.built && id < this->max_models)
+        streaming.txd_assoc.Set(id, this->GetModelTxdIndex(id));
+}
+
+/*
+ *  CAbstractStreaming::TxdAssociation
+ *      Moves a model between the lists of models of each txd only when its txd actually changes
+ */
+void CAbstractStreaming::TxdAssociation::Set(id_t model, id_t txd)
+{
+    if(model >= txd_of.size())
+        txd_of.resize(model + 1, -1);
+
+    auto prev = txd_of[model];
+    if(prev != txd)
     {
-        this->mTxdAssoc.clear();
-        for(auto i = 0u; i < this->max_models; ++i)
+        if(prev != -1)
         {
-            auto txd = this->GetModelTxdIndex(i);
-            if(txd != -1) this->mTxdAssoc[txd].emplace_back(i);
+            auto& models = models_of[prev];
+            models.erase(std::find(models.begin(), models.end(), model));
         }
+        if(txd != -1)
+            models_of[txd].emplace_back(model);
+        txd_of[model] = txd;
     }
 }
 
+auto CAbstractStreaming::TxdAssociation::ModelsUsing(id_t txd) -> const std::vector<id_t>&
+{
+    return models_of[txd];
+}
+
 
 /*
  *  Refresher::BuildRefreshMap
@@ -373,13 +423,30 @@ template<class T> void Refresher<T>::BuildRefreshMap()
 /*
  *  Refresher::BuildEntitiesAssociationMap
  *      Builds association map with entities that needs to be refreshed
+ *      Pools are only walked when a model to be refreshed can be used by their entities (nothing is walked for a refresh of non-models)
  */
 template<class T> void Refresher<T>::BuildEntitiesAssociationMap()
 {
-    BuildEntitiesAssociationForPool<0xB74490, PedPool_t>();         // Ped entities
-    BuildEntitiesAssociationForPool<0xB74494, VehiclePool_t>();     // Vehicle entities
-    BuildEntitiesAssociationForPool<0xB74498, BuildingPool_t>();    // Static entities
-    BuildEntitiesAssociationForPool<0xB7449C, ObjectPool_t>();      // Dynamic entities
+    // Only walk the pools which may have entities using the models to be refreshed
+    bool peds = false, vehicles = false, others = false;
+    for(auto& pair : this->mToRefresh)
+    {
+        auto id = pair.first;
+        if(id < this->max_models && GetModelInfo(id))
+        {
+            switch(GetModelType(id))
+            {
+                case ModelType::Ped:     peds = true;     break;
+                case ModelType::Vehicle: vehicles = true; break;
+                default:                 others = true;   break;
+            }
+        }
+    }
+
+    if(peds)     BuildEntitiesAssociationForPool<0xB74490, PedPool_t>();         // Ped entities
+    if(vehicles) BuildEntitiesAssociationForPool<0xB74494, VehiclePool_t>();     // Vehicle entities
+    if(others)   BuildEntitiesAssociationForPool<0xB74498, BuildingPool_t>();    // Static entities
+    if(others)   BuildEntitiesAssociationForPool<0xB7449C, ObjectPool_t>();      // Dynamic entities
 }
 
 
@@ -609,6 +676,7 @@ template<class T> void Refresher<T>::Clear()
 //
 
 static modloader_shdata_t* shStreamRefresherCreate = 0;
+static modloader_shdata_t* shStreamRefresherCreate2 = 0;
 
 namespace // avoid conflict with the same function defined in <interfaces/gta3/std.stream.hpp>
 {
@@ -620,10 +688,23 @@ namespace // avoid conflict with the same function defined in <interfaces/gta3/s
         return nullptr;
     }
 
+    extern "C" __declspec(dllexport)
+    IStreamRefresher2* StreamRefresherCreate2(uint32_t capabilities, uint32_t flags)
+    {
+        if(gvm.IsSA())
+            return new Refresher<TraitsSA>(*streaming, capabilities);
+        return nullptr;
+    }
+
     static void* StreamRefresherCreatePtr()
     {
         return (void*)(&StreamRefresherCreate);
     }
+
+    static void* StreamRefresherCreate2Ptr()
+    {
+        return (void*)(&StreamRefresherCreate2);
+    }
 }
 
 void CAbstractStreaming::InitRefreshInterface()
@@ -633,6 +714,12 @@ void CAbstractStreaming::InitRefreshInterface()
         shStreamRefresherCreate->type = MODLOADER_SHDATA_FUNCTION;
         shStreamRefresherCreate->f    = StreamRefresherCreatePtr();
     }
+
+    if(shStreamRefresherCreate2 = plugin_ptr->loader->CreateSharedData("StreamRefresherCreate2"))
+    {
+        shStreamRefresherCreate2->type = MODLOADER_SHDATA_FUNCTION;
+        shStreamRefresherCreate2->f    = StreamRefresherCreate2Ptr();
+    }
 }
 
 void CAbstractStreaming::ShutRefreshInterface()
@@ -642,6 +729,12 @@ void CAbstractStreaming::ShutRefreshInterface()
         plugin_ptr->loader->DeleteSharedData(shStreamRefresherCreate);
         shStreamRefresherCreate = 0;
     }
+
+    if(shStreamRefresherCreate2)
+    {
+        plugin_ptr->loader->DeleteSharedData(shStreamRefresherCreate2);
+        shStreamRefresherCreate2 = 0;
+    }
 }
 
 template<class T> void Refresher<T>::Release()
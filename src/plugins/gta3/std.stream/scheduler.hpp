@@ -0,0 +1,153 @@
+/*
+ * Standard Streamer Plugin for Mod Loader
+ * Copyright (C) 2014  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/*
+ *  StreamScheduler
+ *      Dispatches the requests taken by the streaming thread to a set of I/O workers, and completes them
+ *
+ *      A slow read (i.e. a loose abstract file) doesn't hold the requests for the other channels behind it.
+ *      Requests for the same channel always go to the same worker, so there's never more than one read in flight per channel,
+ *      and a request is completed by the thread which read it once it has left its queue (as the stock streaming thread does).
+ *      With less than two workers everything happens in the dispatching thread itself, just like the stock streaming thread.
+ *
+ *      The platform side of the requests is left to the IO type, which must provide:
+ *          token_type                                  What a read gives to the completion of its request
+ *          void       Begin(int channel)               Marks the channel as under work, before its request leaves the game queue
+ *          token_type Read(int channel, int worker)    Reads the piece requested on the channel, 'worker' is -1 on the dispatching thread
+ *          void       Finish(int channel, token_type)  Completes the request on the channel
+ *          void       WorkerStarted(int worker)        Called on each worker thread before it reads anything
+ */
+template<class IO>
+class StreamScheduler
+{
+    public:
+        using token_type = typename IO::token_type;
+
+    private:
+        struct Worker
+        {
+            std::thread             thread;
+            std::mutex              mutex;
+            std::condition_variable wakeup;     // Notified for each request added to the queue, and to quit
+            std::deque<int>         queue;      // Channels to be read by this worker, the first one is being read
+            bool                    quit = false;
+        };
+
+        IO& io;
+        std::vector<std::unique_ptr<Worker>> workers;
+
+    public:
+        StreamScheduler(IO& io, int num_workers) : io(io)
+        {
+            // Less than two workers is no better than reading from the dispatching thread
+            if(num_workers >= 2)
+            {
+                for(int i = 0; i < num_workers; ++i)
+                    workers.emplace_back(new Worker());
+
+                try
+                {
+                    for(int i = 0; i < num_workers; ++i)
+                        workers[i]->thread = std::thread(&StreamScheduler::Run, this, i);
+                }
+                catch(const std::system_error&)
+                {
+                    this->Shutdown();
+                }
+            }
+        }
+
+        ~StreamScheduler()
+        {
+            this->Shutdown();
+        }
+
+        // Number of I/O workers, zero when reading from the dispatching thread
+        int Workers() const
+        {
+            return int(workers.size());
+        }
+
+        // Takes care of the request on the channel 'channel', which is the first in the game queue
+        // 'pop' removes it from the game queue
+        template<class Pop>
+        void Process(int channel, Pop pop)
+        {
+            io.Begin(channel);
+
+            if(workers.size())
+            {
+                // The worker owns the request now, so it can be removed from the game queue right away
+                Worker& w = *workers[channel % workers.size()];
+                pop();
+                if(true)
+                {
+                    std::lock_guard<std::mutex> lock(w.mutex);
+                    w.queue.push_back(channel);
+                }
+                w.wakeup.notify_one();
+            }
+            else
+            {
+                auto token = io.Read(channel, -1);
+                pop();                          // Remove from the queue what we just readed
+                io.Finish(channel, token);
+            }
+        }
+
+        // Tells the workers to quit and waits for them, they finish the requests they've been given before
+        void Shutdown()
+        {
+            for(auto& w : workers)
+            {
+                std::lock_guard<std::mutex> lock(w->mutex);
+                w->quit = true;
+                w->wakeup.notify_one();
+            }
+
+            for(auto& w : workers)
+            {
+                if(w->thread.joinable())
+                    w->thread.join();
+            }
+
+            workers.clear();
+        }
+
+    private:
+        // Loop in search of things to read in the worker queue
+        void Run(int index)
+        {
+            Worker& w = *workers[index];
+            io.WorkerStarted(index);
+
+            std::unique_lock<std::mutex> lock(w.mutex);
+            while(true)
+            {
+                w.wakeup.wait(lock, [&w] { return !w.queue.empty() || w.quit; });
+                if(w.queue.empty())
+                    break;
+
+                int channel = w.queue.front();
+                lock.unlock();
+                auto token = io.Read(channel, index);
+                lock.lock();
+                w.queue.pop_front();
+                lock.unlock();
+                io.Finish(channel, token);
+                lock.lock();
+            }
+        }
+};
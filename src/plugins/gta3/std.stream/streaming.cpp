@@ -21,6 +21,20 @@ CAbstractStreaming::CAbstractStreaming()
 
 CAbstractStreaming::~CAbstractStreaming()
 {
+    this->LogHandleCacheStats();
+    this->stm_handles.Clear();
+    this->stm_resident.Clear();
+
+    // The prefetcher saves resources by their name hash
+    std::map<id_t, hash_t> hashes;
+    for(auto& pair : this->indices) hashes.emplace(pair.second, pair.first);
+    this->prefetch.Shutdown([&hashes](id_t id)
+    {
+        auto it = hashes.find(id);
+        return it != hashes.end()? std::pair<hash_t, bool>(it->second, true) : std::pair<hash_t, bool>(0, false);
+    });
+
+    this->packed.Close();
     DeleteCriticalSection(&cs);
     Fastman92LimitAdjusterDestroy(this->f92la);
 }
@@ -32,6 +46,14 @@ void CAbstractStreaming::InitialiseStructAbstraction()
 
     if(this->f92la.hLib)
         plugin_ptr->Log("Using fastman92limitadjuster (%p).", f92la.hLib);
+
+    // Resource indices are dense, so the maps keyed by index are flat arrays holding all of them
+    id_t count = 0;
+    while(this->InfoForModel(count)) ++count;
+    this->cd_dir.resize(count);
+    this->prev_on_cd.resize(count);
+    this->imports.resize(count);
+    this->indices.reserve(count);
 }
 
 const LibF92LA& CAbstractStreaming::GetF92LA()
@@ -203,6 +225,7 @@ bool CAbstractStreaming::InstallFile(const modloader::file& file)
         // We cannot do much at this point, too many calls may come, repeated calls, uninstalls, well, many things will still happen
         // so we'll delay the actual install to the next frame, put everything on an import list
         this->BeginUpdate();
+        this->InvalidateHandles(&file);
 
         if(IsNonStreamed(&file))
             return false;
@@ -241,6 +264,7 @@ bool CAbstractStreaming::UninstallFile(const modloader::file& file)
     else
     {
         this->BeginUpdate();
+        this->InvalidateHandles(&file);
 
         if(IsNonStreamed(&file))
             return false;
@@ -290,6 +314,35 @@ void CAbstractStreaming::Update()
     }
 }
 
+/*
+ *  CAbstractStreaming::InvalidateHandles
+ *      Closes the cached handles of the specified file, since it has been changed or removed, and stops reading it from the packed archive
+ *      or from memory (resident or prefetched)
+ */
+void CAbstractStreaming::InvalidateHandles(const modloader::file* file)
+{
+    // The packed and prefetched copies of this file are outdated as well
+    this->packed.Forget(file);
+    this->prefetch.Forget(file);
+
+    scoped_lock xlock(this->cs);
+    this->stm_handles.Invalidate(file);
+    this->stm_resident.Invalidate(file);
+}
+
+/*
+ *  CAbstractStreaming::LogHandleCacheStats
+ *      Logs the usage counters of the abstract file handles cache and of the resident abstract files
+ */
+void CAbstractStreaming::LogHandleCacheStats()
+{
+    scoped_lock xlock(this->cs);
+    auto& c = this->stm_handles;
+    plugin_ptr->Log("Abstract file handles cache: %u hits, %u misses, %u evictions.", c.hits, c.misses, c.evictions);
+    auto& r = this->stm_resident;
+    plugin_ptr->Log("Resident abstract files: %u hits, %u stored, %u KiB in use.", r.hits, r.stores, uint32_t(r.Capacity() / 1024));
+}
+
 
 
 
@@ -310,7 +363,7 @@ void CAbstractStreaming::UnimportModel(id_t index)
 {
     // Remove special model related to this index if possible
     auto it = imports.find(index);
-    if(it != imports.end()) erase_from_map(special, it->second.file);
+    if(it != nullptr) erase_from_map(special, it->file);
 
     // Restore model information to stock and erase it from the import list
     this->RestoreInfoForModel(index);
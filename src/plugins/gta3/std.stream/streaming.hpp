@@ -7,12 +7,21 @@
 #define	STREAMING_HPP
 
 #include <list>
+#include <vector>
+#include <algorithm>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <array>
+#include <deque>
+#include <memory>
+#include <atomic>
 
 #include <modloader/modloader.hpp>
 #include <modloader/util/hash.hpp>
 #include <modloader/util/injector.hpp>
 #include <modloader/util/container.hpp>
+#include <modloader/utility.hpp>
 #include "CDirectory.h"
 #include "CStreamingInfo.h"
 
@@ -114,6 +123,292 @@ inline void FillDirectoryEntry(DirectoryInfo& entry, const char* filename, uint3
     entry.m_usSize          = GetSizeInBlocks(size_in_bytes);
 }
 
+/*
+ *  DenseIdMap
+ *      Map from a resource index to T stored as a flat array, resource indices are dense (zero up to the number of streaming infos),
+ *      so a lookup is an array access instead of a tree search. Some of those lookups happen for every resource the game streams.
+ *      Elements don't move as long as the map isn't resized, so pointers to them can be kept around.
+ */
+template<class T>
+class DenseIdMap
+{
+    public:
+        using id_t = uint32_t;
+
+    private:
+        std::vector<T>      items;
+        std::vector<bool>   present;
+        size_t              count_ = 0;
+
+    public:
+        // Makes room for the indices from zero up to (but not including) 'size'
+        void resize(size_t size)
+        {
+            if(size > items.size())
+            {
+                items.resize(size);
+                present.resize(size, false);
+            }
+        }
+
+        // Finds the element at the specified index, null if none
+        T* find(id_t id)
+        {
+            return (id < items.size() && present[id])? &items[id] : nullptr;
+        }
+
+        const T* find(id_t id) const
+        {
+            return (id < items.size() && present[id])? &items[id] : nullptr;
+        }
+
+        size_t count(id_t id) const
+        {
+            return find(id)? 1 : 0;
+        }
+
+        // Gets the element at the specified index, default constructing it if there's none
+        T& operator[](id_t id)
+        {
+            this->resize(id + 1);
+            if(!present[id])
+            {
+                present[id] = true;
+                ++count_;
+            }
+            return items[id];
+        }
+
+        // Adds an element at the specified index if there's none there yet
+        bool emplace(id_t id, const T& value)
+        {
+            if(this->count(id)) return false;
+            (*this)[id] = value;
+            return true;
+        }
+
+        void erase(id_t id)
+        {
+            if(this->count(id))
+            {
+                items[id] = T();
+                present[id] = false;
+                --count_;
+            }
+        }
+
+        // Removes all the elements, keeping the room for them
+        void clear()
+        {
+            std::fill(items.begin(), items.end(), T());
+            std::fill(present.begin(), present.end(), false);
+            count_ = 0;
+        }
+
+        size_t size() const
+        {
+            return count_;
+        }
+};
+
+/*
+ *  CPackedImg
+ *      Packs the loose files from .img folders into a single IMG (VER2) archive in the plugin cache, so streaming them is a read
+ *      from one big file instead of opening and reading a small file each time.
+ *      The archive is kept between runs, only files that changed (size or time) since the last run are written again.
+ *      Writing happens in a background thread, the files being written are streamed from their own file until the next run.
+ */
+class CPackedImg : public modloader::basic_cache
+{
+    public:
+        static const size_t min_files = 512;    // Packs only when at least this many loose files are installed
+
+        // Information about a packed file
+        struct Item
+        {
+            uint32_t path_hash;                 // Hash of the file path (relative to the game dir)
+            uint32_t offset;                    // Offset in the archive (in 2KiB blocks)
+            uint32_t blocks;                    // Size in the archive (in 2KiB blocks)
+            uint32_t _pad;
+            uint64_t size;                      // Size of the file when packed
+            uint64_t time;                      // Write time of the file when packed
+        };
+
+    private:
+        struct Packing;                                     // Work of the packing thread (see packer.cpp)
+
+        HANDLE hArchive = nullptr;                          // Archive handle, for duplication
+        HANDLE hThread  = nullptr;                          // Packing thread, writes the changed files into the archive
+        Packing* packing = nullptr;                         // Work being done by the packing thread
+        std::map<const modloader::file*, Item> items;       // Files currently served from the archive
+
+    public:
+        ~CPackedImg() { this->Close(); }
+
+        // Packs the loose files among 'files' (or updates the previous archive), returns whether there's a usable archive
+        bool Build(ref_list<const modloader::file*> files);
+
+        // Closes the archive, files will be streamed from their loose file again
+        // Waits for the packing thread, which stops after the file it's copying
+        void Close();
+
+        // Finds the packed item for the specified file, null if the file isn't served from the archive
+        const Item* Find(const modloader::file* file) const
+        {
+            auto it = this->items.find(file);
+            return it != items.end()? &it->second : nullptr;
+        }
+
+        // Stops serving the specified file from the archive (i.e. because it has changed on disk)
+        void Forget(const modloader::file* file)
+        {
+            this->items.erase(file);
+        }
+
+        // Gets a new handle to the archive, every open model needs its own handle
+        HANDLE Duplicate() const;
+
+    private:
+        static bool IsPackable(const modloader::file& file);
+        static bool CopyInto(FILE* archive, const std::string& fullpath, uint64_t size, uint32_t offset);
+        static bool Write(Packing& packing);
+        static DWORD __stdcall PackingThread(void*);
+};
+
+
+/*
+ *  CPrefetcher
+ *      Learns which resources the game usually requests after each other (e.g. a ped model followed by the ped it pairs with)
+ *      and reads the abstract files likely to be requested next into memory ahead of time, so the streaming copies them from
+ *      memory instead of reading the disk. What has been learned is kept between runs.
+ */
+class CPrefetcher : public modloader::basic_cache
+{
+    public:
+        using id_t   = uint32_t;
+        using hash_t = uint32_t;
+
+        static const size_t   max_successors = 4;                   // Successors learned for each resource
+        static const size_t   memory_budget  = 16 * 1024 * 1024;    // Maximum memory taken by prefetched files
+        static const size_t   max_file_size  = memory_budget / 16;  // Bigger files aren't worth keeping in memory
+        static const size_t   max_jobs       = 16;                  // Maximum files waiting to be prefetched
+        static const uint32_t min_count      = 2;                   // Times a successor must have been seen to be prefetched
+
+        uint32_t hits   = 0;        // Number of reads served from memory
+        uint32_t misses = 0;        // Number of prefetched reads which couldn't be served (still being read or outdated)
+        uint32_t wasted = 0;        // Number of prefetched files dropped without being used
+
+    private:
+        struct successor
+        {
+            id_t     id    = 0;
+            uint32_t count = 0;     // Times this successor has been seen, zero for an unused successor
+        };
+
+        struct job
+        {
+            id_t                    id;
+            const modloader::file*  file;
+            std::string             path;
+            uint64_t                size;
+            uint32_t                generation; // See CPrefetcher::generation
+        };
+
+        struct buffer
+        {
+            const modloader::file*  file;
+            std::vector<char>       data;
+        };
+
+        std::map<id_t, std::array<successor, max_successors>> table;   // Learned successors of each resource
+        id_t last = -1;                                                 // Last resource requested
+
+        CRITICAL_SECTION cs;                    // Protects everything below, which is shared with the reading thread
+        HANDLE hThread    = nullptr;            // Thread reading the prefetched files
+        HANDLE hSemaphore = nullptr;            // Released once for each job
+        std::deque<job> jobs;                   // Files waiting to be read
+        std::map<id_t, buffer> buffers;         // Files read into memory
+        std::deque<id_t> order;                 // Order the buffers have been read, to drop the oldest when over budget
+        size_t used = 0;                        // Memory taken by the buffers
+        uint32_t generation = 0;                // Increased every time a file is forgotten, so outdated reads get dropped
+        id_t reading = -1;                      // Resource being read by the reading thread, -1 if none
+        bool exiting = false;                   // Tells the reading thread to exit
+
+    public:
+        CPrefetcher();
+        ~CPrefetcher();
+
+        // Loads what has been learned in previous runs and starts the reading thread
+        // 'find_model' translates a resource name hash to its index (-1 if none)
+        void Startup(std::function<id_t(hash_t)> find_model);
+        // Saves what has been learned and stops the reading thread
+        // 'find_hash' translates a resource index to its name hash
+        void Shutdown(std::function<std::pair<hash_t, bool>(id_t)> find_hash);
+
+        // Learns from a resource request and prefetches the resources likely requested next (call from the game thread only)
+        // 'prefetchable' gives the abstract file of a resource worth prefetching, null if it isn't
+        void OnRequest(id_t id, std::function<const modloader::file*(id_t)> prefetchable);
+
+        // Copies the prefetched content of the file at the specified index into 'dest', false if it hasn't been prefetched
+        bool Serve(id_t id, const modloader::file* file, void* dest);
+
+        // Drops the prefetched content of the specified file (i.e. because it has changed on disk)
+        void Forget(const modloader::file* file);
+
+    private:
+        void Learn(id_t prev, id_t next, uint32_t count = 1);
+        void Enqueue(id_t id, const modloader::file* file);
+        void Insert(job& j, std::vector<char>&& data);
+        void StopThread();
+        std::vector<char> Drop(std::map<id_t, buffer>::iterator it);
+        static DWORD __stdcall ReadingThread(void* param);
+};
+
+
+/*
+ *  CIplProbe
+ *      Finds out whether loose .ipl files are binary IPLs (the only ones handled by the streaming) by peeking their magic.
+ *      What has been peeked is kept between runs by file path, size and time, so unchanged files are never opened again.
+ *      When a file isn't known, all the unknown .ipl files in its folder are peeked at once by a few threads, since the
+ *      files of a folder get asked about one after the other.
+ */
+class CIplProbe : public modloader::basic_cache
+{
+    public:
+        static const size_t max_threads = 4;    // Threads peeking the files of a folder
+        static const size_t min_per_thread = 8; // Files worth an additional thread
+
+        uint32_t hits   = 0;                    // Number of files known without opening them
+        uint32_t peeks  = 0;                    // Number of files opened
+
+        // Information about a peeked file
+        struct Item
+        {
+            uint32_t path_hash;                 // Hash of the file path (relative to the game dir)
+            char     magic[4];                  // First bytes of the file (zeroed if it couldn't be read)
+            uint64_t size;                      // Size of the file when peeked
+            uint64_t time;                      // Write time of the file when peeked
+        };
+
+    private:
+        std::unordered_map<uint32_t, Item> items;   // Peeked files by path hash
+        std::set<uint32_t> folders;                 // Folders already peeked by path hash
+        bool dirty = false;                         // Has anything changed since the items have been loaded?
+
+    public:
+        // Checks whether the specified .ipl file is a binary IPL
+        bool IsBinary(const modloader::file& file);
+
+        // Saves the peeked files for the next run (if anything changed)
+        void Save();
+
+    private:
+        void Load();
+        void PeekFolder(const modloader::file& file);
+        static void Peek(const std::string& fullpath, char (&magic)[4]);
+};
+
+
 /*
  *  CAbstractStreaming
  *      Abstraction around the game's streaming->
@@ -123,7 +418,7 @@ class CAbstractStreaming
 {
     public: // Friends
         template<class T> friend class Refresher;
-        friend int __stdcall CdStreamThread();
+        friend class CdStreamIO;
 
     private:
         LibF92LA f92la;                             //
@@ -142,10 +437,10 @@ class CAbstractStreaming
         using NonStreamedInfo_t = std::pair<const modloader::file*, NonStreamedType>;
 
         // Temporary cd directory for basic information extracting, used during initialization
-        using TempCdDir_t = std::list<std::pair<int, std::deque<DirectoryInfo>>>;
+        using TempCdDir_t = std::list<std::pair<int, std::vector<DirectoryInfo>>>;
         
         // This one stores the extracted informations from the temp cd dir and more.
-        using CdDir_t     = std::map<id_t, struct CdDirectoryItem>;
+        using CdDir_t     = DenseIdMap<struct CdDirectoryItem>;
 
         // Detailed information about a cd directory item
         struct CdDirectoryItem
@@ -186,51 +481,191 @@ class CAbstractStreaming
         {
             protected:
                 friend class CAbstractStreaming;
-                friend int __stdcall CdStreamThread();
+                friend class CdStreamIO;
 
-                HANDLE     handle;                      // OS file handle
-                ModelInfo& info;                        // Model information
-                id_t       index;                       // Model index this is related to
+                HANDLE     handle = nullptr;            // OS file handle
+                ModelInfo* info   = nullptr;            // Model information
+                id_t       index  = 0;                  // Model index this is related to
+                uint64_t   offset = 0;                  // Offset of the model in the file (non-zero when packed)
 
             public:
-                AbctFileHandle(HANDLE handle, ModelInfo& info, int idx)
-                    : handle(handle), info(info), index(idx)
+                AbctFileHandle() = default;
+
+                AbctFileHandle(HANDLE handle, ModelInfo& info, int idx, uint64_t offset)
+                    : handle(handle), info(&info), index(idx), offset(offset)
                 {}
-            
-                // Quickly check if this handle is the same as another
-                bool operator==(const AbctFileHandle& b) const
+        };
+
+        // Table of abstract files currently open for reading, indexed by their OS handle
+        // It's an open addressing table with a fixed number of slots, so no allocation happens while streaming, and its
+        // lookups don't need any lock (they happen in the streaming thread for every request, abstract or not).
+        class AbctFileTable
+        {
+            public:
+                static const size_t capacity = 64;  // Power of two, way more than the files open at the same time
+
+                // Adds an open file into the table, returns null if the table is full (call from the game thread only)
+                AbctFileHandle* Insert(HANDLE handle, ModelInfo& info, id_t index, uint64_t offset);
+                // Finds the open file with the specified OS handle, null if none
+                AbctFileHandle* Find(HANDLE handle);
+                // Removes the open file with the specified OS handle from the table
+                void Erase(HANDLE handle);
+
+            private:
+                // Special slot keys, neither of those can be the handle of an open file
+                static HANDLE empty_key()  { return nullptr; }                  // Never used slot, ends a lookup
+                static HANDLE erased_key() { return INVALID_HANDLE_VALUE; }     // Erased slot, doesn't end a lookup
+                static HANDLE busy_key()   { return (HANDLE)(uintptr_t)(1); }   // Slot being filled by Insert
+
+                // First slot to look for the specified handle (handles are multiple of four)
+                static size_t Hash(HANDLE handle)
                 {
-                    return (this == &b);    // Dirty, but that's how we should go here
+                    return ((uintptr_t)(handle) >> 2) & (capacity - 1);
                 }
-            
-                // Check if this handle has the specified OS file handle bound to it
-                bool operator==(HANDLE h) const
+
+                struct slot
                 {
-                    return (this->handle == h);
-                }
-        };
+                    std::atomic<HANDLE> key { nullptr };
+                    AbctFileHandle      file;
+                };
+
+                slot slots[capacity];
+                std::atomic<size_t> count { 0 };    // Number of files in the table
 
+                slot* FindSlot(HANDLE handle);
+        };
 
         // Information maps, those maps are here to help the abstract streaming with some main streaming information
-        std::map<hash_t, id_t>      indices;            // Association between all game resources name hashes and indices
-        std::map<hash_t, uint32_t>  clothes_map;        // Association between all clothes name hashes and it's item offset
-        std::map<id_t, struct CdDirectoryItem> cd_dir;  // Important information about all resource files in the game
-        std::map<id_t, id_t> prev_on_cd;                // Original InfoForModel next on cd information, <next, prev>
+        std::unordered_map<hash_t, id_t>     indices;       // Association between all game resources name hashes and indices
+        std::unordered_map<hash_t, uint32_t> clothes_map;   // Association between all clothes name hashes and it's item offset
+        DenseIdMap<struct CdDirectoryItem>   cd_dir;        // Important information about all resource files in the game
+        DenseIdMap<id_t> prev_on_cd;                        // Original InfoForModel next on cd information, <next, prev>
 
         // Custom files
         std::map<std::string, const modloader::file*>   raw_models; // Models installed before the streaming initialization ---- (sorted by name!!)
-        std::map<id_t, ModelInfo>                       imports;    // Imported abstract models
-        std::map<hash_t, const modloader::file*>        special;    // Abstract special models ---- (imported by me) (hashed filename has no extension)
+        DenseIdMap<ModelInfo>                           imports;    // Imported abstract models
+        std::unordered_map<hash_t, const modloader::file*> special; // Abstract special models ---- (imported by me) (hashed filename has no extension)
         std::map<uint32_t, const modloader::file*>      clothes;    // Imported abstract clothes --- (key is offset)
-        std::map<hash_t, NonStreamedInfo_t>             non_stream; // Non streamed resources (requested by default.dat/gta.dat) (.second.first may be nullptr)
+        std::unordered_map<hash_t, NonStreamedInfo_t>   non_stream; // Non streamed resources (requested by default.dat/gta.dat) (.second.first may be nullptr)
 
         // Information for refreshing
         std::map<hash_t, const modloader::file*>        to_import;  // Files to be imported by the refresher --- (null pointer on mapped piece means uninstall)
         bool to_rebuild_player = false;                             // Should rebuild the player?
         uint32_t newcloth_blocks = 0;                               // On the player rebuilding process, realloc the streaming buffer if necessary because of this clothing item size (in blocks)
 
+        // Cache of idle open handles of abstract files, so streaming the same model again doesn't need to reopen its file
+        // The handles don't prevent their files from being changed, so the files get checked through them before a read
+        // The handles of a file are closed when the file gets reinstalled or uninstalled, or is found changed before a read
+        struct AbctHandleCache
+        {
+            public:
+                static const size_t max_handles = 32;   // Maximum number of idle handles kept open
+
+                uint32_t hits       = 0;                // Number of opens served by a cached handle
+                uint32_t misses     = 0;                // Number of opens which had to open the file
+                uint32_t evictions  = 0;                // Number of cached handles closed to make room for another
+
+            private:
+                struct entry
+                {
+                    HANDLE                  handle = nullptr;
+                    const modloader::file*  file   = nullptr;
+                    id_t                    index  = 0;
+                    uint32_t                tick   = 0;     // Last time (in Give calls) this entry has been used
+                };
+
+                entry    entries[max_handles];
+                uint32_t tick = 0;
+
+            public:
+                // Takes the cached handle for the file at the specified index (removing it from the cache), null if none
+                HANDLE Take(id_t index, const modloader::file* file);
+                // Gives a no longer used handle to the cache, closing the least recently used handle if the cache is full
+                void Give(HANDLE handle, id_t index, const modloader::file* file);
+                // Gets the information of the file behind the cached handle for the file at the specified index, false if none
+                bool Inspect(id_t index, const modloader::file* file, BY_HANDLE_FILE_INFORMATION& info) const;
+                // Closes the cached handles of the specified file
+                void Invalidate(const modloader::file* file);
+                // Closes all the cached handles
+                void Clear();
+        };
+
+        // Memory copies of small abstract files, so streaming them again doesn't touch the disk at all
+        // The copies are packed into a few big chunks of memory instead of an allocation for each file
+        // The copy of a file is dropped when the file gets reinstalled or uninstalled
+        struct AbctResidentCache
+        {
+            public:
+                static const size_t max_file_size = 64 * 1024;          // Bigger files aren't kept in memory
+                static const size_t memory_budget = 32 * 1024 * 1024;   // Maximum memory taken by the copies, zero disables the cache
+                static const size_t chunk_size    = 1024 * 1024;        // Size of each chunk of memory
+
+                uint32_t hits   = 0;                // Number of reads served by a copy
+                uint32_t stores = 0;                // Number of files copied into memory
+
+            private:
+                struct entry
+                {
+                    const modloader::file*  file;
+                    uint32_t                chunk;  // Chunk the copy is in
+                    uint32_t                offset; // Offset of the copy in the chunk
+                    uint32_t                size;   // Size of the copy (aligned)
+                };
+
+                std::vector<std::unique_ptr<char[]>> chunks;
+                std::map<id_t, entry> entries;
+                size_t chunk_used = chunk_size;     // Bytes used in the last chunk
+                size_t dead       = 0;              // Bytes taken by dropped copies
+
+            public:
+                // Checks whether the specified file is worth keeping in memory
+                static bool IsResidentFile(const modloader::file* file);
+                // Copies the file at the specified index into 'dest', false if it isn't in memory
+                bool Serve(id_t index, const modloader::file* file, void* dest);
+                // Keeps a copy of the file at the specified index, read into 'src', if it's worth it and there's room for it
+                void Store(id_t index, const modloader::file* file, const void* src);
+                // Checks whether the file at the specified index is in memory
+                bool Contains(id_t index, const modloader::file* file) const;
+                // Drops the copies of the specified file
+                void Invalidate(const modloader::file* file);
+                // Drops all the copies
+                void Clear();
+                // Memory taken by the chunks
+                size_t Capacity() const { return chunks.size() * chunk_size; }
+
+            private:
+                void Compact();
+        };
+
+        // Association between tex dictionaries and the models using them, kept between refreshes and updated only where it changes
+        struct TxdAssociation
+        {
+            public:
+                bool built = false;                                     // Has it been built from the model infos yet?
+
+            private:
+                std::vector<id_t> txd_of;                               // Tex dictionary index (starts from zero) of each model, -1 if none
+                std::unordered_map<id_t, std::vector<id_t>> models_of;  // Models using each tex dictionary index
+                std::vector<id_t> touched;                              // Models whose tex dictionary may have changed since they were set
+
+            public:
+                // Sets the tex dictionary index (-1 for none) the specified model uses
+                void Set(id_t model, id_t txd);
+                // Tells the tex dictionary of the specified model may have changed, it gets set again by the next refresher
+                void Touch(id_t model)                      { if(built) touched.emplace_back(model); }
+                // Takes the list of models touched so far
+                std::vector<id_t> TakeTouched()             { std::vector<id_t> list; list.swap(touched); return list; }
+                // Gets the models using the specified tex dictionary index
+                const std::vector<id_t>& ModelsUsing(id_t txd);
+        };
+
         // Abstract streaming
-        std::list<AbctFileHandle> stm_files;                        // List of abstract files currently open for reading
+        AbctFileTable stm_files;                                    // Abstract files currently open for reading
+        AbctHandleCache stm_handles;                                // Idle handles of abstract files (use together with cs)
+        AbctResidentCache stm_resident;                             // Memory copies of small abstract files (use together with cs)
+        TxdAssociation txd_assoc;                                   // Models using each tex dictionary (maintained by the refreshers)
+        CPackedImg packed;                                          // Archive of packed loose files
+        CPrefetcher prefetch;                                       // Reads the abstract files likely to be requested next
 
         // Dynamic cross-game structures caching
         size_t sizeof_CStreamingInfo;                               // The size of the CStreamingInfo structure
@@ -289,6 +724,7 @@ class CAbstractStreaming
         const char* GetCdStreamPath(const char* filepath);
         const char* GetCdDirectoryPath(const char* filepath);
         bool DoesModelNeedsFallback(id_t id);
+        void PrefetchAfter(id_t id);
         static HANDLE TryOpenAbstractHandle(int index, HANDLE hFile);
 
     private:
@@ -305,6 +741,10 @@ class CAbstractStreaming
         // Abstract streaming file managing
         AbctFileHandle* OpenModel(ModelInfo& file, int index);
         void CloseModel(AbctFileHandle* file);
+        void InvalidateHandles(const modloader::file* file);
+        void LogHandleCacheStats();
+        bool ReadFromMemory(AbctFileHandle* file, void* dest);
+        void KeepInMemory(AbctFileHandle* file, const void* src);
         
         // Registering
         void RegisterModelIndex(const char* filename, id_t index);
@@ -337,9 +777,9 @@ class CAbstractStreaming
         void RestoreInfoForModel(id_t id)
         {
             auto it = this->cd_dir.find(id);
-            if(it != cd_dir.end())  // Has a stock directory entry?
+            if(it != nullptr)       // Has a stock directory entry?
             {
-                this->SetInfoForModel(id, it->second.offset, it->second.blocks);
+                this->SetInfoForModel(id, it->offset, it->blocks);
                 RestoreNextOnCdPointingTo(id);
             }
             else
@@ -349,15 +789,15 @@ class CAbstractStreaming
         // Remove the next on cd pointing to the specified model....
         void ClearNextOnCdPointingTo(id_t id)
         {
-            auto prev_pair = prev_on_cd.find(id);
-            if(prev_pair != prev_on_cd.end()) InfoForModel(prev_pair->second)->SetNextOnCd(-1);
+            auto prev = prev_on_cd.find(id);
+            if(prev != nullptr) InfoForModel(*prev)->SetNextOnCd(-1);
         }
 
         // Restore the next on cd pointing to the specified model....
         void RestoreNextOnCdPointingTo(id_t id)
         {
-            auto prev_pair = prev_on_cd.find(id);
-            if(prev_pair != prev_on_cd.end()) InfoForModel(prev_pair->second)->SetNextOnCd(id);
+            auto prev = prev_on_cd.find(id);
+            if(prev != nullptr) InfoForModel(*prev)->SetNextOnCd(id);
         }
 
     public://protected:
@@ -391,7 +831,7 @@ class CAbstractStreaming
         bool FallbackResource(id_t index, bool force = false)
         {
             auto imp = this->imports.find(index);
-            if(imp != imports.end() && imp->second.isFallingBack == false)
+            if(imp != nullptr && imp->isFallingBack == false)
             {
                 if(force == false && this->IsModelOnStreaming(index))
                 {
@@ -401,8 +841,8 @@ class CAbstractStreaming
                 else
                 {
                     plugin_ptr->Log("Falling back resource id %d to stock resource", index);
-                    this->RestoreInfoForModel(imp->first);
-                    imp->second.isFallingBack = true;
+                    this->RestoreInfoForModel(index);
+                    imp->isFallingBack = true;
                     return true;
                 }
             }
@@ -426,14 +866,14 @@ class CAbstractStreaming
         std::pair<hash_t, bool> FindHashFromModel(id_t id)
         {
             auto it = this->cd_dir.find(id);
-            return it != cd_dir.end()? std::pair<hash_t, bool>(it->second.hash, true) : std::pair<hash_t, bool>(0, false);
+            return it != nullptr? std::pair<hash_t, bool>(it->hash, true) : std::pair<hash_t, bool>(0, false);
         }
 
         // Gets the resource type of a resource id
         ResType GetIdType(id_t id)
         {
             auto it = this->cd_dir.find(id);
-            return it != cd_dir.end()? it->second.type : ResType::None;
+            return it != nullptr? it->type : ResType::None;
         }
 
 
@@ -29,6 +29,21 @@ struct data_info<std::array<T, N>> : data_info_base
     }
 };
 
+/*
+ *  data_hash<> specialization for 'std::array<T, N>'
+ */
+template<typename T, std::size_t N>
+struct data_hash<std::array<T, N>>
+{
+    std::size_t operator()(const std::array<T, N>& a) const
+    {
+        std::size_t hash = 0;
+        for(size_t i = 0; i < N; ++i)
+            hash = hash_combine(hash, hash_data(a[i]));
+        return hash;
+    }
+};
+
 
 } // namespace datalib
 
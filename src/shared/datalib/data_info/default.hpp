@@ -5,12 +5,15 @@
  */
 #pragma once
 #include <type_traits>
+#include <functional>
 #include <iosfwd>
+#include <cstddef>
 
 //
 //  This header contains:
 //      [*] default data_info<> objects, including data_info_base
 //      [*] delimopt type (delimiter for optional params in data_slice<>)
+//      [*] default data_hash<> objects
 //
 //
 
@@ -106,6 +109,63 @@ inline bool precompare(const T& a, const T& b)
 #endif
 }
 
+
+/*
+ *  data_hash
+ *      Hashes an object consistently with its equality comparision (equal objects must give equal hashes)
+ *      The default hash is a constant, which is always consistent but makes hashed lookups degrade into linear searches,
+ *      so types with exact equality (integers, strings, etc) have specializations giving meaningful hashes.
+ *      NOTE: Types whose equality isn't exact (e.g. floats compared with an epsilon) must keep the constant hash!!!
+ */
+template<typename T, typename = void>
+struct data_hash
+{
+    std::size_t operator()(const T&) const
+    {
+        return 0;
+    }
+};
+
+/*
+ *  data_hash
+ *      data_hash<> specialization for integral types
+ */
+template<typename T>
+struct data_hash<T, typename std::enable_if<std::is_integral<T>::value>::type>
+{
+    std::size_t operator()(const T& value) const
+    {
+        return std::hash<T>()(value);
+    }
+};
+
+/*
+ *  data_hash
+ *      data_hash<> specialization for enumerations
+ */
+template<typename T>
+struct data_hash<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+    std::size_t operator()(const T& value) const
+    {
+        using underlying_type = typename std::underlying_type<T>::type;
+        return std::hash<underlying_type>()(static_cast<underlying_type>(value));
+    }
+};
+
+// Hashes 'value' using data_hash<>
+template<class T>
+inline std::size_t hash_data(const T& value)
+{
+    return data_hash<T>()(value);
+}
+
+// Combines the hash 'hash' into the hash 'seed'
+inline std::size_t hash_combine(std::size_t seed, std::size_t hash)
+{
+    return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
 template<class T, class CharT, class Traits>
 inline std::basic_ostream<CharT, Traits>& print_separator(std::basic_ostream<CharT, Traits>& os)
 {
@@ -59,6 +59,28 @@ struct data_info<either<Types...>> : data_info_base
         }
 };
 
+/*
+ *  data_hash<> specialization for 'either<Types...>'
+ */
+template<typename ...Types>
+struct data_hash<either<Types...>>
+{
+    std::size_t operator()(const either<Types...>& e) const
+    {
+        return hash_combine(std::size_t(e.which()), apply_visitor(hash_visitor(), e));
+    }
+
+    private:
+        struct hash_visitor : either_static_visitor<std::size_t>
+        {
+            template<class T>
+            std::size_t operator()(const T& value) const
+            {
+                return hash_data(value);
+            }
+        };
+};
+
 
 
 } // namespace datalib
@@ -29,6 +29,18 @@ struct data_info<optional<T>> : data_info<T>
     }
 };
 
+/*
+ *  data_hash<> specialization for 'optional<T>'
+ */
+template<typename T>
+struct data_hash<optional<T>>
+{
+    std::size_t operator()(const optional<T>& opt) const
+    {
+        return opt? hash_combine(1, hash_data(opt.get())) : 0;
+    }
+};
+
 
 } // namespace datalib
 
@@ -27,4 +27,16 @@ struct data_info<std::pair<T1, T2>> : data_info_base
     }
 };
 
+/*
+ *  data_hash<> specialization for 'std::pair<T1, T2>'
+ */
+template<typename T1, typename T2>
+struct data_hash<std::pair<T1, T2>>
+{
+    std::size_t operator()(const std::pair<T1, T2>& p) const
+    {
+        return hash_combine(hash_data(p.first), hash_data(p.second));
+    }
+};
+
 } // namespace datalib
@@ -20,4 +20,16 @@ struct data_info<std::basic_string<CharT, Traits, Allocator>>
     static const char separator = data_info_base::separator;
 };
 
+/*
+ *  data_hash<> specialization for 'std::basic_string<CharT, Traits, Allocator>'
+ */
+template<typename CharT, typename Traits, typename Allocator>
+struct data_hash<std::basic_string<CharT, Traits, Allocator>>
+{
+    std::size_t operator()(const std::basic_string<CharT, Traits, Allocator>& str) const
+    {
+        return std::hash<std::basic_string<CharT, Traits, Allocator>>()(str);
+    }
+};
+
 } // namespace datalib
@@ -71,4 +71,17 @@ struct data_info<tagged_type<T, Tag>> : data_info_tagged<tagged_type<T, Tag>>
 {
 };
 
+/*
+ *  data_hash<> specialization for 'tagged_type<T, Tag>'
+ *  Hashes the wrapped object, tags that change the equality of the wrapped object (e.g. case insensitive strings) must specialize this!
+ */
+template<typename T, class Tag>
+struct data_hash<tagged_type<T, Tag>>
+{
+    std::size_t operator()(const tagged_type<T, Tag>& tt) const
+    {
+        return hash_data(get(tt));
+    }
+};
+
 }
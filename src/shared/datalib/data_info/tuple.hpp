@@ -48,4 +48,29 @@ private:
     }
 };
 
+/*
+ *  data_hash<> specialization for 'std::tuple<Types...>'
+ */
+template<typename ...Types>
+struct data_hash<std::tuple<Types...>>
+{
+    std::size_t operator()(const std::tuple<Types...>& t) const
+    {
+        return hash(std::integral_constant<size_t, 0>(), t, 0);
+    }
+
+private:
+    static std::size_t hash(std::integral_constant<size_t, std::tuple_size<std::tuple<Types...>>::value>,
+        const std::tuple<Types...>& t, std::size_t seed)
+    {
+        return seed;
+    }
+
+    template<size_t I>
+    static std::size_t hash(std::integral_constant<size_t, I>, const std::tuple<Types...>& t, std::size_t seed)
+    {
+        return hash(std::integral_constant<size_t, I+1>(), t, hash_combine(seed, hash_data(std::get<I>(t))));
+    }
+};
+
 } // namespace datalib
@@ -8,6 +8,8 @@
 #include <bitset>
 #include <sstream>
 #include <type_traits>
+#include <boost/utility/string_ref.hpp>
+#include <datalib/detail/packed_bitset.hpp>
 #include <datalib/detail/stream/memstream.hpp>
 #include <datalib/detail/stream/kstream.hpp>
 #include <datalib/detail/mpl/seqeach.hpp>
@@ -23,16 +25,32 @@ namespace datalib {
 #   endif
 #endif
 
+//
+//  Define DATALIB_DATASLICE_PACKED to use the packed representation of data_slice, which is meant for stores with lots of lines:
+//      [*] data_slice_base has no virtual destructor (so no vtable pointer in each slice), do not delete a slice by a data_slice_base pointer!
+//          (std::shared_ptr<data_slice_base> is still fine, since it deletes by the type it was created with)
+//      [*] The used bitset is stored in the smallest unsigned integer able to hold it
+//  The public interface and the serialization format are the same on both representations.
+//
+
 /*
  *  data_slice_base
  *      Allows polymorphic behaviour on a data_slice object
  */
+#if !defined(DATALIB_DATASLICE_PACKED)
 struct data_slice_base
 {
     virtual ~data_slice_base() = 0;
 };
 
 inline data_slice_base::~data_slice_base() { }
+#else
+struct data_slice_base
+{
+    protected:
+        ~data_slice_base() = default;
+};
+#endif
 
 
 /*
@@ -55,7 +73,11 @@ class data_slice : public data_slice_base
         static const size_t tuple_size  = std::tuple_size<tuple_type>::value;
 
         // The bitset type used to determine whether a certain type has been fetched
-        using bitset_type               = std::bitset<tuple_size>;              
+#if !defined(DATALIB_DATASLICE_PACKED)
+        using bitset_type               = std::bitset<tuple_size>;
+#else
+        using bitset_type               = typename std::conditional<(tuple_size <= 64), packed_bitset<tuple_size>, std::bitset<tuple_size>>::type;
+#endif
 
 #if !defined(DATALIB_DATASLICE_NOSORT)
         // 'sorted_type_indices' is a integer_sequence with the tuple indices sorted by complexity (less complexies first)
@@ -66,8 +88,8 @@ class data_slice : public data_slice_base
 
     protected:
         tuple_type  tuple;              // Tuple to store the types
-        bitset_type used;               // Bitset determining whether a certain tuple indice is in use
-        size_t      used_count = 0;     // Number of bits set in the bitset
+        bitset_type used;               // Bitset determining whether a certain tuple indice is in use (the number of types stored is it's count)
+        mutable size_t fphash = 0;      // Cached fingerprint of the content, zero if not computed yet (see fingerprint())
 
     public:
 
@@ -78,13 +100,14 @@ class data_slice : public data_slice_base
         data_slice() = default;
 
         data_slice(const data_slice& rhs)
-            : tuple(rhs.tuple), used(rhs.used), used_count(rhs.used_count)
+            : tuple(rhs.tuple), used(rhs.used), fphash(rhs.fphash)
         {}
 
         data_slice(data_slice&& rhs)
-            : tuple(std::move(rhs.tuple)), used(std::move(rhs.used)), used_count(rhs.used_count)
+            : tuple(std::move(rhs.tuple)), used(rhs.used), fphash(rhs.fphash)
         {
-            rhs.used_count = 0;
+            rhs.used.reset();
+            rhs.fphash = 0;
         }
 
         template<class Arg1, class... Args>
@@ -102,16 +125,17 @@ class data_slice : public data_slice_base
         {
             this->tuple = rhs.tuple;
             this->used  = rhs.used;
-            this->used_count = rhs.used_count;
+            this->fphash = rhs.fphash;
             return *this;
         }
 
         data_slice& operator=(data_slice&& rhs)
         {
             this->tuple = std::move(rhs.tuple);
-            this->used  = std::move(rhs.used);
-            this->used_count = rhs.used_count;
-            rhs.used_count = 0;
+            this->used  = rhs.used;
+            this->fphash = rhs.fphash;
+            rhs.used.reset();
+            rhs.fphash = 0;
             return *this;
         }
 
@@ -130,8 +154,9 @@ class data_slice : public data_slice_base
         }
 
         // Sets the content of this data storer to be what's on the line (by interpreting it)
+        // The reading follows the same rules as 'check' does, so there's no need to check before setting.
         // Returns false on failure
-        bool set(const std::string& line)
+        bool set(boost::string_ref line)
         {
             return scan_to_tuple(line) >= min_count();
         }
@@ -145,21 +170,50 @@ class data_slice : public data_slice_base
 
         // Cheaply checks whether the content of 'line' can be stored in this data storer
         // If this return true, mostly like 'this->set(line)' will also return true
-        bool check(const std::string& line) const
+        bool check(boost::string_ref line) const
         {
             auto this_ = const_cast<data_slice*>(this);              // and here we go breaking constness
             return this_->check_on_tuple(line) >= min_count();
         }
 
+        // Hashes the content of this data storer consistently with 'operator=='
+        std::size_t hash() const
+        {
+            hashy_from_tuple hasher(*this);
+            foreach_in_tuple(const_cast<tuple_type&>(tuple), hasher);
+            return hasher.hash;
+        }
+
+        // Gets the fingerprint of the content of this data storer, which is it's hash computed lazily and cached
+        // Any non-const access to the content (get, set, reset, assignment, deserialization) invalidates the fingerprint
+        std::size_t fingerprint() const
+        {
+            if(this->fphash == 0)
+            {
+                auto hash = this->hash();
+                this->fphash = (hash? hash : 1);
+            }
+            return this->fphash;
+        }
+
         // Gets an element from the data tuple
         template<size_t I>
         auto get() -> decltype(std::get<I>(std::declval<tuple_type&>()))
         {
             static_assert(I < tuple_size, "Invalid slice element index");
             using result_type = decltype(std::get<I>(std::declval<tuple_type&>()));
+            this->fphash = 0;   // the element may get modified by the caller
             return std::forward<result_type>(std::get<I>(this->tuple));
         }
 
+        // Gets an element from the data tuple for reading only, the fingerprint is kept
+        template<size_t I>
+        auto get() const -> decltype(std::get<I>(std::declval<const tuple_type&>()))
+        {
+            static_assert(I < tuple_size, "Invalid slice element index");
+            return std::get<I>(this->tuple);
+        }
+
         // Sets the nth element I from this data silce to the specified object
         template<size_t I, class T>
         auto set(T&& obj) -> decltype(std::get<I>(std::declval<tuple_type&>()))
@@ -169,10 +223,7 @@ class data_slice : public data_slice_base
             if(this->used.test(I) == false)
             {
                 if(!ignores<I>())
-                {
                     this->used.set(I);
-                    ++this->used_count;
-                }
             }
             using result_type = decltype(std::get<I>(std::declval<tuple_type&>()));
             return std::forward<result_type>(this->get<I>());
@@ -182,7 +233,7 @@ class data_slice : public data_slice_base
         void reset()
         {
             this->used.reset();
-            this->used_count = 0;
+            this->fphash = 0;
         }
 
         // Resets the state of the object at index i
@@ -191,7 +242,7 @@ class data_slice : public data_slice_base
             if(this->used.test(i))
             {
                 this->used.reset(i);
-                --this->used_count;
+                this->fphash = 0;
             }
         }
 
@@ -204,14 +255,15 @@ class data_slice : public data_slice_base
         // Determines the number of types being stored in this data storer
         int count() const
         {
-            return this->used_count;
+            return int(this->used.count());
         }
 
         // Determines the number of optional types being stored in this data storer
         int optcount() const
         {
-            if(this->used_count > min_count())      // if greater than min_count we have optional items, otherwise nope
-                return used_count - min_count();
+            auto count = this->count();
+            if(count > min_count())                 // if greater than min_count we have optional items, otherwise nope
+                return count - min_count();
             return 0;
         }
 
@@ -233,7 +285,12 @@ class data_slice : public data_slice_base
         template<class Archive>
         void serialize(Archive& ar)
         {
-            ar(this->tuple, this->used_count, this->used);
+            // The archive format is the tuple, the number of types stored and a std::bitset, no matter the representation
+            size_t used_count = this->count();
+            std::bitset<tuple_size> used_bits = to_std_bitset(this->used);
+            ar(this->tuple, used_count, used_bits);
+            this->used = bitset_type(used_bits);
+            this->fphash = 0;
         }
 
     protected:
@@ -249,11 +306,22 @@ class data_slice : public data_slice_base
             return false;
         }
 
+        // Converts the used bitset into a std::bitset
+        static const std::bitset<tuple_size>& to_std_bitset(const std::bitset<tuple_size>& bits)
+        {
+            return bits;
+        }
+        template<size_t N>
+        static std::bitset<N> to_std_bitset(const packed_bitset<N>& bits)
+        {
+            return bits.to_bitset();
+        }
+
         template<size_t I>
         static bool ignores()
         {
             static_assert(I < tuple_size, "Invalid slice element index");
-            return data_info<std::tuple_element<I, tuple_type>::type>::ignore;
+            return data_info<typename std::tuple_element<I, tuple_type>::type>::ignore;
         }
 
         void private_set(std::integral_constant<size_t, tuple_size>)
@@ -272,29 +340,37 @@ class data_slice : public data_slice_base
     private:
 
         // Scans the content of 'line' to 'this->tuple' and returns the amount of type successfully scanned
-        int scan_to_tuple(const std::string& line)
+        int scan_to_tuple(boost::string_ref line)
         {
-            imemstream stream(line, std::ios::in);
+            token_list tokens(line.begin(), line.end());                        // Tokenize once, shared by all the types (and their alternatives)
+            this->reset();                                  // Reset used bitset
+            if(tokens.count() < min_token_count())          // Not enough tokens for the required types, fail fast
+                return 0;
+
+            imemstream stream(line.data(), line.size(), tokens);
             scany_to_tuple<false> scanner(*this, stream);   // Scanner functor
-            this->reset();                                  // Reset used bitset and counter
             foreach_in_tuple(tuple, scanner);               // Perform the scanning (this rearranges the bitset)
-            return (this->used_count = scanner.counter);    // Re-set the counter
+            return scanner.counter;
         }
 
         // Prints the content of 'this->tuple' to the 'line' and returns the amount of types successfully printed
         int print_from_tuple(std::string& line) const
         {
-            std::ostringstream stream(std::ios::out);
+            line.clear();                                   // Reuses the memory from 'line'
+            omemstream stream(line);
             printy_from_tuple printer(*this, stream);       // Priter functor
             foreach_in_tuple(const_cast<tuple_type&>(tuple), printer);
-            line = stream.str();
             return printer.counter;
         }
 
         // Checks how many types are possible to scan from 'line' into 'this->tuple'
-        int check_on_tuple(const std::string& line)
+        int check_on_tuple(boost::string_ref line)
         {
-            icheckstream stream(line);
+            token_list tokens(line.begin(), line.end());
+            if(tokens.count() < min_token_count())
+                return 0;
+
+            icheckstream stream(line.data(), line.size(), &tokens);
             scany_to_tuple<true> checker(*this, stream);
             foreach_in_tuple(tuple, checker);
             return checker.counter;
@@ -350,6 +426,20 @@ class data_slice : public data_slice_base
             return do_count_until<dummy_type>();
         }
 
+        // Finds the minimum number of tokens a line needs to have in order to be scanned into this data storer
+        static std::size_t min_token_count()
+        {
+            static const auto count = find_min_token_count();
+            return count;
+        }
+
+        static std::size_t find_min_token_count()
+        {
+            count_tokens_until_type<delimopt> f;
+            foreach_type_variadic<Types...>()(f);
+            return f.counter;
+        }
+
 
     private:
 
@@ -400,10 +490,10 @@ class data_slice : public data_slice_base
         struct printy_from_tuple
         {
             const data_slice&    self;
-            std::ostringstream&  stream;
+            omemstream&          stream;
             int                  counter;
             
-            printy_from_tuple(const data_slice& self, std::ostringstream& stream)
+            printy_from_tuple(const data_slice& self, omemstream& stream)
                 : self(self), stream(stream), counter(0)
             {}
 
@@ -413,7 +503,7 @@ class data_slice : public data_slice_base
             {
                 if(self.used[Integral::value])
                 {
-                    perform_print<Integral::value, TypeWr::type>(value);
+                    perform_print<Integral::value, typename TypeWr::type>(value);
                 }
                 return !!stream;
             }
@@ -433,6 +523,26 @@ class data_slice : public data_slice_base
             }
         };
 
+        // Hashes from tuple
+        struct hashy_from_tuple
+        {
+            const data_slice&   self;
+            std::size_t         hash;
+
+            hashy_from_tuple(const data_slice& self)
+                : self(self), hash(self.count())
+            {}
+
+            // Hashes tuple index, unused indices are part of the hash since equality requires the same used state
+            template<class Integral, class TypeWr>
+            bool operator()(Integral, TypeWr, typename TypeWr::type& value)
+            {
+                if(self.used[Integral::value])
+                    hash = hash_combine(hash, hash_combine(Integral::value, hash_data(value)));
+                return true;
+            }
+        };
+
         
 
         // Compares the data from two data storers
@@ -517,21 +627,51 @@ class data_slice : public data_slice_base
             }
         };
 
+        // Functor used to sum the minimum number of tokens of the types received until the type 'Until' is received
+        template<class Until>
+        struct count_tokens_until_type
+        {
+            std::size_t counter = 0;
+
+            template<class Index, class TypeW>
+            bool operator()(Index, TypeW)
+            {
+                using Type = typename TypeW::type;
+                if(!data_info<Type>::ignore)
+                    counter += datalib::min_tokens<Type>::value;
+                else if(std::is_same<Type, Until>::value)
+                    return false;
+                return true;
+            }
+        };
+
 };
 
 
+/*
+ *  data_hash<> specialization for 'data_slice<Types...>'
+ */
+template<typename ...Types>
+struct data_hash<data_slice<Types...>>
+{
+    std::size_t operator()(const data_slice<Types...>& data) const
+    {
+        return data.fingerprint();
+    }
+};
+
 // CXX14 HELP-ME
 
 template<size_t I, class ...Types> inline
-auto get(data_slice<Types...>& data) -> decltype(std::declval<data_slice<Types...>&>().get<I>())
+auto get(data_slice<Types...>& data) -> decltype(std::declval<data_slice<Types...>&>().template get<I>())
 {
-    return data.get<I>();
+    return data.template get<I>();
 }
 
 template<size_t I, class ...Types> inline
-auto get(const data_slice<Types...>& data) -> std::add_const_t<decltype(get<I>(std::declval<data_slice<Types...>&>()))>
+auto get(const data_slice<Types...>& data) -> decltype(std::declval<const data_slice<Types...>&>().template get<I>())
 {
-    return get<I>(const_cast<data_slice<Types...>&>(data));
+    return data.template get<I>();
 }
 
 
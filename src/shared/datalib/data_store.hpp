@@ -30,6 +30,7 @@ class data_store
         using key_type       = typename container_type::key_type;
         using mapped_type    = typename container_type::mapped_type;
         using pair_type      = typename container_type::value_type;
+        using allocator_type = typename container_type::allocator_type;
 
         // Is the container_type a sorted container type? Let's find it out.
         static const bool is_sorted = is_sorted_container<container_type>::value;
@@ -47,6 +48,11 @@ class data_store
 
         data_store() = default;
 
+        // Constructs an empty store whose container allocates memory using 'alloc'
+        explicit data_store(const allocator_type& alloc) :
+            map(alloc)
+        {}
+
         data_store(const data_store& rhs) :
             is_ready(rhs.is_ready), is_default(rhs.is_default), map(rhs.map)
         {}
@@ -80,6 +86,9 @@ class data_store
         container_type& container()             { return this->map; }
         const container_type& container() const { return this->map; }
 
+        // Gets the allocator used by the container
+        allocator_type get_allocator() const    { return this->map.get_allocator(); }
+
         // Loads content into this store, making it ready. If it was already ready, no work is performed.
         // The content is loaded by a user-defined functor, parser, which can send one argument to itself.
         // Must be static because of derived classes, which needs to specify their actual type ('StoreType')
@@ -109,8 +118,8 @@ class data_store
         }
 
         // Checks the state of this object
-        bool ready() const   { return this->is_ready; }
-        bool default() const { return this->is_default; }
+        bool ready() const              { return this->is_ready; }
+        bool is_default_store() const   { return this->is_default; }
 
 
     public: // not to be used directly
@@ -52,6 +52,9 @@ class basic_linear_map
 
         basic_linear_map() = default;
 
+        explicit basic_linear_map(const allocator_type& alloc)
+            : list(alloc) {}
+
         basic_linear_map(const basic_linear_map& rhs)
             : list(rhs.list) {}
 
@@ -63,10 +66,10 @@ class basic_linear_map
         //
 
         basic_linear_map& operator=(const basic_linear_map& rhs)
-        { this->list = rhs.list; }
+        { this->list = rhs.list; return *this; }
 
         basic_linear_map& operator=(basic_linear_map&& rhs)
-        { this->list = std::move(rhs.list); }
+        { this->list = std::move(rhs.list); return *this; }
 
 
         //
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace datalib {
+
+/*
+ *  buffered_file_writer
+ *
+ *      Writes a text file through a big reusable buffer, which gets flushed to the file in big chunks (one fwrite per chunk).
+ *      The content is written into a temporary file ('filename' + ".tmp") and only replaces 'filename' on commit(),
+ *      so a failed or interrupted write never leaves a truncated file behind.
+ *      If the writer is destroyed without being commited, the temporary file is discarded.
+ *
+ */
+class buffered_file_writer
+{
+    public:
+        static const std::size_t chunk_size = 256 * 1024;
+
+        explicit buffered_file_writer(const char* filename) :
+            filename(filename), tempname(this->filename + ".tmp"), file(nullptr), failed(false)
+        {
+            // Text mode, so newlines get translated just like a std::ofstream would do
+            this->file = std::fopen(tempname.c_str(), "w");
+            if(this->file)
+            {
+                std::setvbuf(file, nullptr, _IONBF, 0);   // we do our own buffering
+                buffer.reserve(chunk_size);
+            }
+        }
+
+        buffered_file_writer(const buffered_file_writer&) = delete;
+        buffered_file_writer& operator=(const buffered_file_writer&) = delete;
+
+        ~buffered_file_writer()
+        {
+            if(file)
+            {
+                std::fclose(file);
+                std::remove(tempname.c_str());
+            }
+        }
+
+        // Checks whether the writer is in a good state
+        explicit operator bool() const
+        {
+            return file != nullptr && !failed;
+        }
+
+        // Appends content to the output
+        buffered_file_writer& write(const char* data, std::size_t size)
+        {
+            if(buffer.size() + size > chunk_size)
+            {
+                flush();
+                if(size >= chunk_size)  // too big for the buffer, go straight to the file
+                {
+                    if(file && std::fwrite(data, 1, size, file) != size) failed = true;
+                    return *this;
+                }
+            }
+            buffer.insert(buffer.end(), data, data + size);
+            return *this;
+        }
+
+        buffered_file_writer& operator<<(const std::string& str)
+        {
+            return write(str.data(), str.size());
+        }
+
+        buffered_file_writer& operator<<(const char* str)
+        {
+            return write(str, std::strlen(str));
+        }
+
+        buffered_file_writer& operator<<(char c)
+        {
+            if(buffer.size() == chunk_size) flush();
+            buffer.push_back(c);
+            return *this;
+        }
+
+        // Writes the buffered content to the file
+        bool flush()
+        {
+            if(file && !buffer.empty())
+            {
+                if(std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+                    failed = true;
+                buffer.clear();
+            }
+            return !!(*this);
+        }
+
+        // Flushes and closes the temporary file and atomically replaces the destination file with it
+        // Returns false on failure, in which case the destination file is left untouched
+        bool commit()
+        {
+            if(!file) return false;
+
+            bool good = flush();
+            if(std::fclose(file) != 0) good = false;
+            file = nullptr;
+
+            if(good)
+            {
+#ifdef _WIN32
+                good = MoveFileExA(tempname.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+                good = std::rename(tempname.c_str(), filename.c_str()) == 0;
+#endif
+            }
+
+            if(!good) std::remove(tempname.c_str());
+            return good;
+        }
+
+    private:
+        std::string         filename;
+        std::string         tempname;
+        std::FILE*          file;
+        bool                failed;
+        std::vector<char>   buffer;
+};
+
+} // namespace datalib
@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace datalib {
+
+/*
+ *  read_buffer_pool
+ *
+ *      Keeps the memory of the buffers used to read files that cannot be mapped, so repeated reads don't reallocate.
+ *
+ */
+class read_buffer_pool
+{
+    public:
+        // Takes a (empty) buffer from the pool, or a new buffer if the pool is empty
+        static std::vector<char> acquire()
+        {
+            std::lock_guard<std::mutex> lock(instance().mutex);
+            auto& buffers = instance().buffers;
+            if(buffers.empty())
+                return std::vector<char>();
+
+            std::vector<char> buffer = std::move(buffers.back());
+            buffers.pop_back();
+            return buffer;
+        }
+
+        // Gives the buffer back to the pool
+        static void release(std::vector<char>&& buffer)
+        {
+            if(buffer.capacity())
+            {
+                buffer.clear();
+                std::lock_guard<std::mutex> lock(instance().mutex);
+                instance().buffers.emplace_back(std::move(buffer));
+            }
+        }
+
+    private:
+        std::mutex                     mutex;
+        std::vector<std::vector<char>> buffers;
+
+        static read_buffer_pool& instance()
+        {
+            static read_buffer_pool pool;
+            return pool;
+        }
+};
+
+
+/*
+ *  mapped_file
+ *
+ *      Gives a [begin(), end()) range of mutable characters with the content of a file.
+ *      The file is mapped in copy-on-write mode, so the range can be modified without touching the file itself.
+ *      When the file cannot be mapped (pipes, devices, address space exhaustion...) it's read into a pooled buffer instead.
+ *
+ */
+class mapped_file
+{
+    public:
+        mapped_file() :
+            mbegin(nullptr), msize(0), mapped(false), opened(false)
+        {}
+
+        explicit mapped_file(const char* filename) :
+            mapped_file()
+        {
+            this->open(filename);
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file(mapped_file&&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+        mapped_file& operator=(mapped_file&&) = delete;
+
+        ~mapped_file()
+        {
+            this->close();
+        }
+
+        // Opens the file 'filename', closing the previosly opened one
+        bool open(const char* filename)
+        {
+            this->close();
+            this->opened = (this->map(filename) || this->read(filename));
+            return this->opened;
+        }
+
+        // Closes the currently open file
+        void close()
+        {
+            if(this->mapped)
+                this->unmap();
+            if(this->buffer.capacity())
+                read_buffer_pool::release(std::move(this->buffer));
+
+            this->buffer = std::vector<char>();
+            this->mbegin = nullptr;
+            this->msize  = 0;
+            this->mapped = false;
+            this->opened = false;
+        }
+
+        bool is_open() const        { return this->opened; }
+        bool is_mapped() const      { return this->mapped; }
+
+        char* begin()               { return this->mbegin; }
+        char* end()                 { return this->mbegin + this->msize; }
+        std::size_t size() const    { return this->msize; }
+
+    private:
+        char*               mbegin;
+        std::size_t         msize;
+        bool                mapped;     // the range is a file mapping
+        bool                opened;
+        std::vector<char>   buffer;     // the range is this buffer when the file couldn't be mapped
+
+        // Reads the file by streaming it into a pooled buffer
+        bool read(const char* filename)
+        {
+            static const std::size_t chunk_size = 65536;
+
+            std::ifstream stream(filename, std::ios::binary);
+            if(stream)
+            {
+                this->buffer = read_buffer_pool::acquire();
+
+                std::size_t length = 0;
+                do
+                {
+                    this->buffer.resize(length + chunk_size);
+                    stream.read(this->buffer.data() + length, chunk_size);
+                    length += std::size_t(stream.gcount());
+                } while(stream);
+
+                if(stream.bad())
+                    return false;
+
+                this->buffer.resize(length);
+                this->mbegin = this->buffer.data();
+                this->msize  = length;
+                return true;
+            }
+            return false;
+        }
+
+#ifdef _WIN32
+        bool map(const char* filename)
+        {
+            // Not shared for writing, a writer in another process would change the mapped pages while they're parsed
+            HANDLE hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if(hFile != INVALID_HANDLE_VALUE)
+            {
+                LARGE_INTEGER filesize;
+                if(GetFileType(hFile) == FILE_TYPE_DISK && GetFileSizeEx(hFile, &filesize)
+                && ULONGLONG(filesize.QuadPart) <= ULONGLONG(SIZE_MAX))
+                {
+                    if(filesize.QuadPart == 0)  // empty files cannot be mapped, but there's nothing to read anyway
+                    {
+                        CloseHandle(hFile);
+                        return true;
+                    }
+
+                    if(HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr))
+                    {
+                        if(void* view = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0))
+                        {
+                            this->mbegin = static_cast<char*>(view);
+                            this->msize  = std::size_t(filesize.QuadPart);
+                            this->mapped = true;
+                        }
+                        CloseHandle(hMapping);  // the view keeps the mapping alive
+                    }
+                }
+                CloseHandle(hFile);
+            }
+            return this->mapped;
+        }
+
+        void unmap()
+        {
+            UnmapViewOfFile(this->mbegin);
+        }
+#else
+        bool map(const char* filename)
+        {
+            int fd = ::open(filename, O_RDONLY);
+            if(fd != -1)
+            {
+                struct stat st;
+                if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && (unsigned long long)(st.st_size) <= (unsigned long long)(SIZE_MAX))
+                {
+                    if(st.st_size == 0)         // empty files cannot be mapped, but there's nothing to read anyway
+                    {
+                        ::close(fd);
+                        return true;
+                    }
+
+                    void* view = mmap(nullptr, std::size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                    if(view != MAP_FAILED)
+                    {
+                        madvise(view, std::size_t(st.st_size), MADV_SEQUENTIAL);
+                        this->mbegin = static_cast<char*>(view);
+                        this->msize  = std::size_t(st.st_size);
+                        this->mapped = true;
+                    }
+                }
+                ::close(fd);  // the mapping keeps the file alive
+            }
+            return this->mapped;
+        }
+
+        void unmap()
+        {
+            munmap(this->mbegin, this->msize);
+        }
+#endif
+};
+
+
+} // namespace datalib
@@ -0,0 +1,226 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <new>
+#include <limits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace datalib {
+
+/*
+ *  monotonic_arena
+ *
+ *      Memory resource which hands out memory from big chunks by just bumping a pointer, deallocation is a no-op.
+ *      All the memory is given back at once by release() (or the destructor), so it's meant for short lived sets of objects,
+ *      such as the data stores of a single merge, where the objects are destroyed all together.
+ *
+ */
+class monotonic_arena
+{
+    public:
+        static const std::size_t min_chunk_size = 64 * 1024;
+        static const std::size_t max_chunk_size = 4 * 1024 * 1024;
+
+        monotonic_arena() :
+            chunks(nullptr), cur(nullptr), end(nullptr), next_size(min_chunk_size),
+            bytes_allocated(0), bytes_reserved(0), peak_reserved(0), num_allocations(0)
+        {}
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena()
+        {
+            this->release();
+        }
+
+        // Allocates 'size' bytes aligned to 'align' bytes from the arena
+        void* allocate(std::size_t size, std::size_t align)
+        {
+            char* p = align_up(cur, align);
+            if(p == nullptr || std::size_t(end - p) < size)
+            {
+                this->new_chunk(size + align);
+                p = align_up(cur, align);
+            }
+            cur = p + size;
+            bytes_allocated += size;
+            ++num_allocations;
+            return p;
+        }
+
+        // Memory is only given back on release()
+        void deallocate(void*, std::size_t)
+        {
+        }
+
+        // Gives back all the memory allocated by this arena to the system
+        // Every object which has memory from this arena must have been destroyed already
+        void release()
+        {
+            while(chunks)
+            {
+                chunk_header* next = chunks->next;
+                ::operator delete(chunks);
+                chunks = next;
+            }
+            cur = end = nullptr;
+            next_size = min_chunk_size;
+            bytes_allocated = bytes_reserved = 0;
+            num_allocations = 0;
+        }
+
+        std::size_t allocated() const   { return bytes_allocated; }     // Bytes handed out since the last release
+        std::size_t reserved() const    { return bytes_reserved; }      // Bytes taken from the system since the last release
+        std::size_t peak() const        { return peak_reserved; }       // Highest amount of bytes ever taken from the system
+        std::size_t allocations() const { return num_allocations; }     // Number of allocations since the last release
+
+    private:
+        struct chunk_header
+        {
+            chunk_header* next;
+        };
+
+        chunk_header*   chunks;             // Linked list of chunks, the most recent first
+        char*           cur;                // Current position in the most recent chunk
+        char*           end;                // End of the most recent chunk
+        std::size_t     next_size;          // Size of the next chunk to allocate
+        std::size_t     bytes_allocated;
+        std::size_t     bytes_reserved;
+        std::size_t     peak_reserved;
+        std::size_t     num_allocations;
+
+        static char* align_up(char* p, std::size_t align)
+        {
+            if(p == nullptr) return nullptr;
+            auto addr = reinterpret_cast<std::uintptr_t>(p);
+            return p + ((align - (addr % align)) % align);
+        }
+
+        void new_chunk(std::size_t min_size)
+        {
+            std::size_t size = next_size;
+            while(size < min_size + sizeof(chunk_header)) size *= 2;
+
+            auto* chunk = static_cast<chunk_header*>(::operator new(size));
+            chunk->next = chunks;
+            chunks = chunk;
+            cur = reinterpret_cast<char*>(chunk) + sizeof(chunk_header);
+            end = reinterpret_cast<char*>(chunk) + size;
+
+            bytes_reserved += size;
+            if(bytes_reserved > peak_reserved) peak_reserved = bytes_reserved;
+            if(next_size < max_chunk_size) next_size *= 2;
+        }
+};
+
+
+/*
+ *  arena_allocator
+ *
+ *      Standard allocator which allocates from a monotonic_arena, or from the free store if it has no arena.
+ *      The arena must be given explicitly, a default constructed allocator uses the free store.
+ *      Just like the polymorphic allocators, a container keeps the arena it has been created with for it's entire life
+ *      (the allocator isn't propagated on assignments), and a copy constructed container uses the free store, so a copy
+ *      never outlives the arena of the container it was copied from. Move construction takes the arena of the moved container.
+ *
+ */
+template<class T>
+class arena_allocator
+{
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+
+        template<class U>
+        struct rebind { using other = arena_allocator<U>; };
+
+        arena_allocator() :
+            arena(nullptr)
+        {}
+
+        explicit arena_allocator(monotonic_arena* arena) :
+            arena(arena)
+        {}
+
+        template<class U>
+        arena_allocator(const arena_allocator<U>& rhs) :
+            arena(rhs.resource())
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            if(n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+                throw std::bad_alloc();
+            if(arena)
+                return static_cast<T*>(arena->allocate(n * sizeof(T), std::alignment_of<T>::value));
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n)
+        {
+            if(arena)
+                arena->deallocate(p, n * sizeof(T));
+            else
+                ::operator delete(p);
+        }
+
+        template<class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+            ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        template<class U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+
+        size_type max_size() const
+        {
+            return (std::numeric_limits<std::size_t>::max)() / sizeof(T);
+        }
+
+        arena_allocator select_on_container_copy_construction() const
+        {
+            return arena_allocator();
+        }
+
+        monotonic_arena* resource() const
+        {
+            return this->arena;
+        }
+
+    private:
+        monotonic_arena* arena;
+};
+
+template<class T, class U>
+inline bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+    return a.resource() == b.resource();
+}
+
+template<class T, class U>
+inline bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+    return a.resource() != b.resource();
+}
+
+} // namespace datalib
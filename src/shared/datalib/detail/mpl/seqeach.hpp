@@ -22,6 +22,14 @@ namespace detail
         using type = T;
     };
 
+    // The terminating overloads are declared first so the recursive calls can find them
+    template<int N, class Functor>
+    inline void foreach_type_asfunc(Functor& functor);
+    template<int N, class Functor, class Tuple>
+    inline void foreach_in_tuple(Tuple& tuple, Functor& functor);
+    template<size_t Max, class Functor>
+    inline void foreach_index(std::integral_constant<size_t, Max>, std::integral_constant<size_t, Max>, Functor& functor);
+
     template<int N, class Functor, typename Type, typename... Types>
     inline void foreach_type_asfunc(Functor& functor)
     {
@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace datalib {
+
+/*
+ *  ordered_hash_set
+ *
+ *      A set of unique values which keeps the insertion order.
+ *      The values are kept in a dense vector (iteration happens on it) and indexed by an open addressing (linear probing) hash table.
+ *      The hash of each value is stored along with it so the index can be rebuilt without hashing again.
+ *
+ */
+template<class T, class Hash, class KeyEqual>
+class ordered_hash_set
+{
+    public:
+        using value_type     = T;
+        using size_type      = std::size_t;
+        using iterator       = typename std::vector<T>::const_iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        ordered_hash_set(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+            hasher(hash), equal(equal), shift(0)
+        {}
+
+        // Inserts 'value' if there's no value equal to it yet.
+        // Returns an iterator to the value in the set and whether the value got inserted.
+        std::pair<iterator, bool> insert(const T& value)
+        {
+            if((values.size() + 1) * 2 > slots.size())
+                this->rehash(slots.empty()? 16 : slots.size() * 2);
+
+            std::size_t hash = hasher(value);
+            for(std::size_t i = this->slot_for(hash); ; i = (i + 1) & (slots.size() - 1))
+            {
+                if(slots[i] == 0)
+                {
+                    values.emplace_back(value);
+                    hashes.emplace_back(hash);
+                    slots[i] = std::uint32_t(values.size());
+                    return std::make_pair(values.end() - 1, true);
+                }
+                else
+                {
+                    std::size_t pos = slots[i] - 1;
+                    if(hashes[pos] == hash && equal(values[pos], value))
+                        return std::make_pair(values.begin() + pos, false);
+                }
+            }
+        }
+
+        // Reserves space for at least 'count' values
+        void reserve(size_type count)
+        {
+            values.reserve(count);
+            hashes.reserve(count);
+            if(count * 2 > slots.size())
+            {
+                std::size_t nslots = 16;
+                while(nslots < count * 2) nslots *= 2;
+                this->rehash(nslots);
+            }
+        }
+
+        void clear()
+        {
+            values.clear();
+            hashes.clear();
+            slots.clear();
+            shift = 0;
+        }
+
+        size_type size() const          { return values.size(); }
+        bool empty() const              { return values.empty(); }
+
+        const_iterator begin() const    { return values.begin(); }
+        const_iterator end() const      { return values.end(); }
+
+    private:
+        Hash                        hasher;
+        KeyEqual                    equal;
+        std::vector<T>              values;     // the values, in insertion order
+        std::vector<std::size_t>    hashes;     // the hash of each value in 'values'
+        std::vector<std::uint32_t>  slots;      // the hash table, each slot is a index in 'values' plus one (zero means empty)
+        int                         shift;      // amount of bits to shift the scrambled hash to get a slot index
+
+        // Gets the preferred slot for the specified hash (fibonacci hashing, so weak hashes such as integers get spread)
+        std::size_t slot_for(std::size_t hash) const
+        {
+            const std::size_t multiplier = (sizeof(std::size_t) > 4? std::size_t(0x9E3779B97F4A7C15ull) : std::size_t(0x9E3779B9u));
+            return (hash * multiplier) >> shift;
+        }
+
+        // Rebuilds the hash table with 'nslots' slots, 'nslots' must be a power of two
+        void rehash(std::size_t nslots)
+        {
+            int bits = 0;
+            while((std::size_t(1) << bits) < nslots) ++bits;
+
+            this->slots.assign(nslots, 0);
+            this->shift = int(sizeof(std::size_t) * 8) - bits;
+
+            for(std::size_t pos = 0; pos < values.size(); ++pos)
+            {
+                std::size_t i = this->slot_for(hashes[pos]);
+                while(slots[i] != 0) i = (i + 1) & (nslots - 1);
+                slots[i] = std::uint32_t(pos + 1);
+            }
+        }
+};
+
+} // namespace datalib
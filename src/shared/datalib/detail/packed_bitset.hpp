@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <bitset>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+namespace datalib {
+
+/*
+ *  packed_bitset
+ *
+ *      A fixed size set of bits stored in the smallest unsigned integer able to hold 'N' bits (N must be at most 64).
+ *      std::bitset always uses at least one machine word (sometimes a 64 bits word), this one uses one byte for up to 8 bits and so on.
+ *      Only the subset of std::bitset operations needed by data_slice is implemented.
+ *
+ */
+template<std::size_t N>
+class packed_bitset
+{
+    static_assert(N <= 64, "packed_bitset supports at most 64 bits, use std::bitset instead");
+
+    public:
+        using word_type = typename std::conditional<(N <= 8),  std::uint8_t,
+                          typename std::conditional<(N <= 16), std::uint16_t,
+                          typename std::conditional<(N <= 32), std::uint32_t,
+                                                               std::uint64_t>::type>::type>::type;
+
+        packed_bitset() : bits(0)
+        {}
+
+        explicit packed_bitset(const std::bitset<N>& rhs) : bits(0)
+        {
+            for(std::size_t i = 0; i < N; ++i)
+                if(rhs.test(i)) this->set(i);
+        }
+
+        bool test(std::size_t i) const          { return (bits & bit(i)) != 0; }
+        bool operator[](std::size_t i) const    { return test(i); }
+        packed_bitset& set(std::size_t i)       { bits |= bit(i); return *this; }
+        packed_bitset& reset(std::size_t i)     { bits &= word_type(~bit(i)); return *this; }
+        packed_bitset& reset()                  { bits = 0; return *this; }
+        bool any() const                        { return bits != 0; }
+        bool none() const                       { return bits == 0; }
+
+        // Number of bits set
+        std::size_t count() const
+        {
+            std::size_t n = 0;
+            for(word_type x = bits; x; x &= word_type(x - 1)) ++n;
+            return n;
+        }
+
+        // Converts into a std::bitset (used for serialization, to keep the same format as a std::bitset)
+        std::bitset<N> to_bitset() const
+        {
+            std::bitset<N> result;
+            for(std::size_t i = 0; i < N; ++i)
+                if(test(i)) result.set(i);
+            return result;
+        }
+
+        bool operator==(const packed_bitset& rhs) const { return bits == rhs.bits; }
+        bool operator!=(const packed_bitset& rhs) const { return bits != rhs.bits; }
+
+    private:
+        word_type bits;
+
+        static word_type bit(std::size_t i)
+        {
+            return word_type(word_type(1) << i);
+        }
+};
+
+} // namespace datalib
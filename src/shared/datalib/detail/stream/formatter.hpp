@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <limits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+namespace datalib {
+
+/*
+ *  formatter
+ *
+ *      Lightweight number formatting into character buffers, the output counterpart of scanner.
+ *      The output is always in the classic ("C") locale, which is how the game reads the data files back.
+ *
+ */
+struct formatter
+{
+    // Formats the real number 'value' with the least amount of significant digits that reads back (by atof/strtof) into the very same value.
+    // The output uses the "%g" notation, so trailing zeros are never written and the output for a value is always the same.
+    // Returns the length of the output (not counting the null terminator) or 0 on failure. The buffer should have at least 32 characters.
+    template<class T>
+    static std::size_t format_shortest(char* buf, std::size_t size, T value)
+    {
+        static_assert(std::is_floating_point<T>::value, "format_shortest requires a floating point type");
+
+        const int max_digits = std::numeric_limits<T>::digits10 + 3;    // any value with this many significant digits round trips
+        int min_digits = std::numeric_limits<T>::digits10;              // any normal value with less significant digits than this round trips
+
+        if(!std::isfinite(value))
+            return print(buf, size, max_digits, value);
+
+        if(value != 0 && std::abs(value) < (std::numeric_limits<T>::min)())
+            min_digits = 1;     // subnormals have less precision
+
+        // The first precision that round trips gives the shortest text, since all lower precisions that would
+        // also round trip give the same text once the trailing zeros are taken out by %g
+        std::size_t len = 0;
+        for(int digits = min_digits; digits <= max_digits; ++digits)
+        {
+            len = print(buf, size, digits, value);
+            if(len == 0 || digits == max_digits || read_back(buf, (T*)(nullptr)) == value)
+                break;
+        }
+
+        // %g switches to the exponent notation when the exponent is not less than the precision,
+        // but for big integral values the plain notation may be shorter (e.g. 19093090 instead of 1.909309e+07)
+        if(len != 0)
+        {
+            if(const char* e = std::strchr(buf, 'e'))
+            {
+                int exponent = std::atoi(e + 1);
+                if(exponent > 0 && exponent < 2 * max_digits && std::size_t(exponent + 1) < len)
+                {
+                    char tmp[64];
+                    auto tmplen = print(tmp, sizeof(tmp), exponent + 1, value);
+                    if(tmplen != 0 && tmplen < len && tmplen < size)
+                    {
+                        std::memcpy(buf, tmp, tmplen + 1);
+                        len = tmplen;
+                    }
+                }
+            }
+        }
+
+        return len;
+    }
+
+    private:
+
+        // Prints 'value' with the specified number of significant digits
+        static std::size_t print(char* buf, std::size_t size, int digits, double value)
+        {
+            int len = std::snprintf(buf, size, "%.*g", digits, value);
+            return (len > 0 && std::size_t(len) < size)? std::size_t(len) : 0;
+        }
+
+        static std::size_t print(char* buf, std::size_t size, int digits, long double value)
+        {
+            int len = std::snprintf(buf, size, "%.*Lg", digits, value);
+            return (len > 0 && std::size_t(len) < size)? std::size_t(len) : 0;
+        }
+
+        // Reads back the text the same way the game does (atof, then converted to the wanted type)
+        static float read_back(const char* buf, float*)                { return float(std::strtod(buf, nullptr)); }
+        static double read_back(const char* buf, double*)              { return std::strtod(buf, nullptr); }
+        static long double read_back(const char* buf, long double*)    { return std::strtold(buf, nullptr); }
+};
+
+
+} // namespace datalib
@@ -10,10 +10,13 @@ namespace datalib {
 
 // from memorybuf.hpp
 class memorybuf;
+class appendbuf;
 
 // from memstream.hpp
 template<class CharT, class Traits = std::char_traits<CharT>>
 class basic_imemstream;
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_omemstream;
 
 // from kstream.hpp
 template<typename CharT, typename Traits = std::char_traits<CharT>>
@@ -26,6 +29,9 @@ using icheckstream = basic_icheckstream<char, std::char_traits<char>>;
 // Alias the imemstream object
 using imemstream = basic_imemstream<char, std::char_traits<char>>;
 
+// Alias the omemstream object
+using omemstream = basic_omemstream<char, std::char_traits<char>>;
+
 
 
 } // namespace datalib
@@ -8,6 +8,8 @@
 #include <cctype>
 #include <datalib/detail/stream/fwd.hpp>
 #include <datalib/detail/stream/memorybuf.hpp>
+#include <datalib/detail/stream/scanner.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 
 namespace datalib {
 
@@ -18,6 +20,7 @@ namespace datalib {
  *      Does not send anything to anywhere, just checks. If a conversion cannot be perfoemd, failbit is set.
  *      Used as a fast checking way if a conversion can be made without taking time to actually convert.
  *      Use the 'operator>>' to check if a conversion is possible.
+ *      When constructed with a token_list of the buffer, the checks use the already classified tokens instead of scanning.
  *
  *      Template parameters:
  *          @CharT  -- Type of character to deal with
@@ -36,20 +39,21 @@ class basic_icheckstream : public virtual std::basic_ios<CharT, Traits>
         using typename base::int_type;
         using typename base::traits_type;
         
-        std::streamsize m_gcount;       // Number of characters extracted from the last operation
-        memorybuf       m_rdbuf;        // Buffering object
+        std::streamsize     m_gcount;       // Number of characters extracted from the last operation
+        memorybuf           m_rdbuf;        // Buffering object
+        const token_list*   m_tokens;       // Tokens of the buffer (may be null)
 
     public:
 
         // Constructs the object 
-        basic_icheckstream(const std::string& str) :
-            m_gcount(0), m_rdbuf(str.data(), str.length())
+        basic_icheckstream(const std::string& str, const token_list* tokens = nullptr) :
+            m_gcount(0), m_rdbuf(str.data(), str.length()), m_tokens(tokens)
         {
             base::init(&m_rdbuf);
         }
 
-        basic_icheckstream(const char* str, size_t size) :
-            m_gcount(0), m_rdbuf(str, size)
+        basic_icheckstream(const char* str, size_t size, const token_list* tokens = nullptr) :
+            m_gcount(0), m_rdbuf(str, size), m_tokens(tokens)
         {
             base::init(&m_rdbuf);
         }
@@ -79,6 +83,14 @@ class basic_icheckstream : public virtual std::basic_ios<CharT, Traits>
         // Returns pointer to the underlying raw string device object. 
         memorybuf* rdbuf()
         { return &m_rdbuf; }
+
+        // Returns the tokens of the buffer, or null if the stream wasn't constructed with them
+        const token_list* tokens() const
+        { return m_tokens; }
+
+        // Returns the number of tokens left in the stream (an upper bound of it if the stream has no tokens)
+        std::size_t remaining_tokens() const
+        { return m_tokens? m_tokens->remaining(m_rdbuf.gcur()) : std::size_t(-1); }
 	
         // Sets the input position indicator to absolute (relative to the beginning of the file) value pos
         basic_icheckstream& seekg(pos_type pos)
@@ -259,11 +271,13 @@ class basic_icheckstream : public virtual std::basic_ios<CharT, Traits>
         // Forwarded from operators>> with integer values
         basic_icheckstream& check_integer()
         {
-            reposer xrepos(*this, true);
-            sentry  xsentry(*this);
+            sentry xsentry(*this);
             if(xsentry)
             {
-                return xrepos(!!this->may_match_sign().could_match_base().match_integer_by_base().match_end());
+                auto basefield = this->flags() & std::ios_base::basefield;
+                if(auto token = this->find_token(basefield == std::ios_base::dec || basefield == 0))
+                    return this->check_token(token->is(token_list::integer)? token->end : nullptr);
+                return this->check_token(scanner::match_integer(rdbuf()->gcur(), rdbuf()->gend(), basefield));
             }
             return *this;
         }
@@ -271,11 +285,12 @@ class basic_icheckstream : public virtual std::basic_ios<CharT, Traits>
         /// Forwarded from operators>> with floating point values
         basic_icheckstream& check_real()
         {
-            reposer xrepos(*this, true);
-            sentry  xsentry(*this);
+            sentry xsentry(*this);
             if(xsentry)
             {
-                return xrepos(!!this->match_float().match_end());
+                if(auto token = this->find_token(true))
+                    return this->check_token(token->is(token_list::real)? token->end : nullptr);
+                return this->check_token(scanner::match_real(rdbuf()->gcur(), rdbuf()->gend()));
             }
             return *this;
         }
@@ -283,207 +298,28 @@ class basic_icheckstream : public virtual std::basic_ios<CharT, Traits>
         // Forwarded from operator>> with boolean values
         basic_icheckstream& check_bool()
         {
-            reposer xrepos(*this, true);
-            sentry  xsentry(*this);
+            sentry xsentry(*this);
             if(xsentry)
             {
-                return xrepos(!!this->match_bool().match_end());
+                bool boolalpha = !!(this->flags() & std::ios_base::boolalpha);
+                if(auto token = this->find_token(!boolalpha))
+                    return this->check_token(token->is(token_list::boolean)? token->end : nullptr);
+                return this->check_token(scanner::match_bool(rdbuf()->gcur(), rdbuf()->gend(), boolalpha));
             }
             return *this;
         }
 
-    protected: // Matchers
-
-        //
-        // Meaning of function namings:
-        //  may_    means may or mayn't match depending if it's present
-        //  could_  means may or mayn't match depending on stream flags
-        //  try_    is the same as may_ but returns a boolean specifying if match has been matched
-        // 
-
-        // Tries to match either a '+' or '-' sign.
-        bool try_match_sign()
+        // Finds the classified token at the stream pointer, if 'classified' is false (the token kinds don't apply to the check) gives null
+        const token_list::token* find_token(bool classified)
         {
-            if(*this)
-            {
-                auto x = sgetc();
-                if(x == '+' || x == '-') return !!skipc(x);
-            }
-            return false;
+            return (classified && m_tokens)? m_tokens->at(rdbuf()->gcur()) : nullptr;
         }
 
-        // Tries to match either a '+' or '-' sign
-        basic_icheckstream& may_match_sign()
+        // Finishes a check by moving the stream pointer to the end of the matched token 'p' (or failing if it is null)
+        basic_icheckstream& check_token(const char* p)
         {
-            this->try_match_sign();
-            return *this;
-        }
-
-        // Could match a base (0x, 0, none) depending on the format flags
-        basic_icheckstream& could_match_base()
-        {
-            int_type c;
-            if(*this)
-            {
-                if(!traits_type::eq_int_type(sgetc(), traits_type::eof()))
-                {
-                    if(this->flags() & std::ios_base::hex)
-                    {
-                        if(sbumpc() == '0')
-                        {
-                            if((c = sbumpc(), c == 'x' || c == 'X'))
-                                return *this;
-                            if(!traits_type::eq_int_type(c, traits_type::eof()))
-                                sungetc();
-                        }
-                        sungetc();
-                    }
-                    else if(this->flags() & std::ios_base::oct)
-                    {
-                        if(sbumpc() == '0') return *this;
-                        sungetc();
-                    }
-                }
-            }
-            return *this;
-        }
-
-
-        // Finishes a match by checking if the current character is a blank space
-        basic_icheckstream& match_end()
-        {
-            if(*this)
-            {
-                auto c = sbumpc();
-                if(!this->is_separator(c))
-                    return this->failed();
-            }
-            return *this;
-        }
-
-
-
-        // Matches a boolean 'true'/'false' or '1'/'0', depending on the boolalpha format flag.
-        basic_icheckstream& match_bool()
-        {
-            if(*this)
-            {
-                if(this->flags() & std::ios_base::boolalpha)
-                {
-                    // Only accepts 'true' and 'false', not 'TRUE' and 'FALSE'
-                    streambuf_iterator it(this->rdbuf());
-                    
-                    if(*it == 't')
-                    {
-                        // Must be "true"
-                        if(!(*++it == 'r' && *++it == 'u' && *++it == 'e' && (++it, true)))
-                            return failed();
-                    }
-                    else if(*it == 'f')
-                    {
-                        // Must be "false"
-                        if(!(*++it == 'a' && *++it == 'l' && *++it == 's' && *++it == 'e' && (++it, true)))
-                            return failed();
-                    }
-                    else // Hmm, it should've matched something
-                        return failed();
-                }
-                else
-                {
-                    // Just try '0' and '1' for booleans
-                    int_type c = sbumpc();
-                    if(!(c == '0' || c == '1')) return failed();
-                }
-            }
-            return *this;
-        }
-
-        // Matches a integer using the base set in the showbase format flags
-        basic_icheckstream& match_integer_by_base()
-        {
-            return match_integer([this](int c) {
-                    return (this->flags() & std::ios_base::hex? isxdigit :
-                            this->flags() & std::ios_base::oct? isodigit :
-                            isdigit)(c);
-            });
-        }
-
-        // Matches a integer assuming base 10
-        icheckstream& match_integer()
-        {
-            return match_integer([](int c) { return isdigit(c); });  // functors can be inlined by most compilers while function pointers cannot
-        }
-
-        // Matches a integer assuming the digits characters for this integer return true when passed to (isdigit)
-        template<class IsDigitFunctor>
-        basic_icheckstream& match_integer(IsDigitFunctor isdigit)
-        {
-            if(*this)
-            {
-                int_type c = sgetx();
-                if(!traits_type::eq_int_type(c, traits_type::eof()))
-                {
-                    if(!isdigit(c)) return this->failed();
-                    for(c = snextc(); isdigit(c); c = snextc()) {}
-                }
-            }
-            return *this;
-        }
-
-        // Matches a real number (supports exponents)
-        basic_icheckstream& match_float()
-        {
-            if(*this)
-            {
-                bool has_exp = false;       // Has found a exponential base
-                int_type c;
-
-                // Tries to match a decimal base
-                auto try_match_decimal = [this, &has_exp](int_type c) -> bool
-                {
-                    if(*this)
-                    {
-                        if(c == '.')
-                        {
-                            skipc(c);
-                            if(isdigit(sgetc()))
-                                return !this->match_integer().fail();
-                            return true;
-                        }
-                    }
-                    return false;
-                };
-
-                // Tries to match a exponential base
-                auto try_match_exponent = [this, &has_exp](int_type c) -> bool
-                {
-                    if(*this)
-                    {
-                        if(!has_exp && (c == 'e' || c == 'E'))
-                        {
-                            has_exp = true;
-                            skipc(c);
-                            return !this->may_match_sign().match_integer().fail();
-                        }
-                    }
-                    return false;
-                };
-
-                // Do the actual matching of the floating point
-                if(this->may_match_sign().match_integer())
-                {
-                    // After the initial integer, we can have either a decimal point or exponent
-                    c = sgetc();
-                    if(!try_match_decimal(c) && !try_match_exponent(c))
-                        return *this;
-
-                    // After a decimal digit we can only have a exponent
-                    // We cannot have another decimal after a decimal or after a exponent
-                    c = sgetc();
-                    if(!try_match_exponent(c))
-                        return *this;
-                }
-            }
+            if(p == nullptr) return this->failed();
+            rdbuf()->gseek(p);
             return *this;
         }
 
@@ -537,60 +373,12 @@ class basic_icheckstream : public virtual std::basic_ios<CharT, Traits>
             return rdbuf()->sgetc();
         }
 
-        // Gets the current character on the streambuf and then increases the stream pointer
-        int_type sbumpc()
-        {
-            return rdbuf()->sbumpc();
-        }
-
         // Gets the next character on the streambuf and then increases the stream pointer to point to that character
         int_type snextc()
         {
             return rdbuf()->snextc();
         }
 
-        // Moves the next pointer in the input sequence back by one 
-        int_type sungetc()
-        {
-            return rdbuf()->sungetc();
-        }
-
-
-
-
-        // Skips the current character assuming it's the same as c
-        // Causes failure bits to be set if the current character is not c
-        basic_icheckstream& skipc(int_type c)
-        {
-            if(!traits_type::eq_int_type(sbumpc(), c)) return this->failed();
-            return *this;
-        }
-
-        // Helper, if the character x is blank, cause failure bits to be set and returns eof.
-        int_type xaux(int_type x)
-        {
-            if(traits_type::eq_int_type(x, traits_type::eof()) || isspace(x))
-            {
-                this->failed();
-                return traits_type::eof();
-            }
-            return x;
-        }
-
-        // Gets the current character on the streambuf and then increases the stream pointer
-        // If the captured character is blank, causes failure bits to be set and returns eof
-        int_type sbumpx()
-        {
-            return xaux(sbumpc());
-        }
-
-        // Gets the current character on the streambuf without modifying the stream pointer
-        // If the captured character is blank, causes failure bits to be set and returns eof
-        int_type sgetx()
-        {
-            return xaux(sgetc());
-        }
-
 
 
     public:
@@ -645,7 +433,7 @@ basic_icheckstream<CharT, Traits>& basic_icheckstream<CharT, Traits>::read_strin
     typename icheckstream::sentry  xsentry(is);
     if(xsentry)
     {
-        std::ios_base::iostate state = 0;               // State of the stream after the operation
+        std::ios_base::iostate state = std::ios_base::goodbit; // State of the stream after the operation
         auto n = count; // no need to (count-1) because std::string does not need a null terminator
         if(sideff) str.erase(); // optional side effect
 
@@ -706,7 +494,7 @@ basic_icheckstream<CharT, Traits>& operator>>(basic_icheckstream<CharT, Traits>&
     typename icheckstream::sentry  xsentry(is);
     if(xsentry)
     {
-        std::ios_base::iostate state = 0;               // State of the stream after the operation
+        std::ios_base::iostate state = std::ios_base::goodbit; // State of the stream after the operation
         auto n = count - 1;
 
         if(count > 1)   // If has space only for one character, extract nothing but puts a null terminator on 's'
@@ -5,6 +5,8 @@
  */
 #pragma once
 #include <strstream>
+#include <streambuf>
+#include <string>
 
 namespace datalib {
 
@@ -38,6 +40,18 @@ class memorybuf : public std::strstreambuf
         std::streamsize size() const
         { return msize; }
 
+        // Gets the current position of the input sequence
+        const char* gcur() const
+        { return gptr(); }
+
+        // Gets the end of the input sequence
+        const char* gend() const
+        { return egptr(); }
+
+        // Moves the current position of the input sequence to 'p' (which must be in the range [gcur(), gend()])
+        void gseek(const char* p)
+        { gbump(int(p - gptr())); }
+
     private:
         int pcount() const
         { /* nope */ return 0; }
@@ -48,5 +62,47 @@ class memorybuf : public std::strstreambuf
 };
 
 
+/*
+ *  appendbuf
+ *
+ *      An streambuf implementation that appends stuff to the end of a std::string
+ *      Unlike stringbuf, this writes directly into the string given by the user, so the string memory can be reused between lines.
+ *      This allows only output operations.
+ *
+ */
+class appendbuf : public std::streambuf
+{
+    public:
+        explicit appendbuf(std::string& str) :
+            str(str)
+        {}
+
+        appendbuf(const appendbuf&) = delete;
+        appendbuf(appendbuf&&) = delete;
+        appendbuf& operator=(const appendbuf&) = delete;
+        appendbuf& operator=(appendbuf&&) = delete;
+
+        std::string& string()
+        { return str; }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if(!traits_type::eq_int_type(c, traits_type::eof()))
+                str.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char_type* s, std::streamsize count) override
+        {
+            str.append(s, std::size_t(count));
+            return count;
+        }
+
+    private:
+        std::string& str;
+};
+
+
 
 } // namespace datalib
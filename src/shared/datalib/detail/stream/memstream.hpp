@@ -5,15 +5,24 @@
  */
 #pragma once
 #include <istream>
+#include <ostream>
+#include <locale>
 #include <string>
+#include <new>
+#include <cstdio>
+#include <type_traits>
 #include <datalib/detail/stream/fwd.hpp>
 #include <datalib/detail/stream/memorybuf.hpp>
+#include <datalib/detail/stream/scanner.hpp>
+#include <datalib/detail/stream/tokens.hpp>
+#include <datalib/detail/stream/kstream.hpp>
 
 namespace datalib {
 
 /*
  *  basic_imemstream
  *      An istream which reads from a memory buffer
+ *      When constructed with a token_list of the buffer, tokens of the wrong kind are rejected without being scanned
  */
 template<class CharT, class Traits>
 class basic_imemstream : public std::basic_istream<CharT, Traits>
@@ -21,57 +30,322 @@ class basic_imemstream : public std::basic_istream<CharT, Traits>
     private:
         using base = std::basic_istream<CharT, Traits>;
         using typename base::char_type;
+        using checker_type = basic_icheckstream<CharT, Traits>;
+        using checker_storage = typename std::aligned_storage<sizeof(checker_type), std::alignment_of<checker_type>::value>::type;
 
-        memorybuf m_rdbuf;
+        memorybuf         m_rdbuf;
+        const token_list* m_tokens;     // Tokens of the buffer (may be null)
+        checker_storage   m_checker;    // Storage for the checker(), constructed on demand
+        bool              m_has_checker;
 
     public:
         explicit basic_imemstream(const std::string& str, std::ios_base::openmode mode = std::ios_base::in) : 
-            base(&m_rdbuf), m_rdbuf(str.data(), str.length())
+            base(&m_rdbuf), m_rdbuf(str.data(), str.length()), m_tokens(nullptr), m_has_checker(false)
         {}
 
         explicit basic_imemstream(const void* buf, size_t size,  std::ios_base::openmode mode = std::ios_base::in) : 
-            base(&m_rdbuf), m_rdbuf(buf, size)
+            base(&m_rdbuf), m_rdbuf(buf, size), m_tokens(nullptr), m_has_checker(false)
         {}
 
+        basic_imemstream(const std::string& str, const token_list& tokens) : 
+            base(&m_rdbuf), m_rdbuf(str.data(), str.length()), m_tokens(&tokens), m_has_checker(false)
+        {}
+
+        basic_imemstream(const char* buf, size_t size, const token_list& tokens) : 
+            base(&m_rdbuf), m_rdbuf(buf, size), m_tokens(&tokens), m_has_checker(false)
+        {}
+
+        ~basic_imemstream()
+        {
+            if(m_has_checker) reinterpret_cast<checker_type&>(m_checker).~checker_type();
+        }
+
         // Returns pointer to the underlying raw string device object. 
         memorybuf* rdbuf()
         { return &m_rdbuf; }
 
+        // Returns the tokens of the buffer, or null if the stream wasn't constructed with them
+        const token_list* tokens() const
+        { return m_tokens; }
+
+        // Returns the number of tokens left in the stream (an upper bound of it if the stream has no tokens)
+        std::size_t remaining_tokens() const
+        { return m_tokens? m_tokens->remaining(m_rdbuf.gcur()) : std::size_t(-1); }
+
+        // Returns a check stream over the same buffer (and tokens) positioned where this stream is
+        // The check stream is constructed only once and then reused, so each alternative resolution (e.g. either<>) doesn't pay for a new stream
+        checker_type& checker()
+        {
+            auto& icheck = reinterpret_cast<checker_type&>(m_checker);
+            if(!m_has_checker)
+            {
+                new (&m_checker) checker_type((const char*)(m_rdbuf.buffer()), size_t(m_rdbuf.size()), m_tokens);
+                m_has_checker = true;
+            }
+            icheck.clear();
+            icheck.rdbuf()->gseek(m_rdbuf.gcur());
+            return icheck;
+        }
+
         // too lazy to implement those
         basic_imemstream(const basic_imemstream&) = delete;
         basic_imemstream(basic_imemstream&&) = delete;
         basic_imemstream& operator=(const basic_imemstream&) = delete;
         basic_imemstream& operator=(basic_imemstream&&) = delete;
 
-        // ...
+        // Arithmetic and character extractors
+        // Those do not go thru the locale facets, they scan directly from the memory buffer by using datalib::scanner.
+        // Notice those extractors are strict, the token must be followed by a separator (see scanner for the acceptance rules),
+        // thus a successful read also means a successful check (see icheckstream) and there's no need to check before reading.
         basic_imemstream& operator>>(short& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(unsigned short& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(int& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(unsigned int& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(long& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(unsigned long& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(long long& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(unsigned long long& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_integer(value); }
         basic_imemstream& operator>>(float& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_real(value); }
         basic_imemstream& operator>>(double& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_real(value); }
         basic_imemstream& operator>>(long double& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_real(value); }
         basic_imemstream& operator>>(bool& value)
-        { return base::operator>>(value), *this; }
+        { return this->scan_bool(value); }
+        basic_imemstream& operator>>(char& value)
+        { return this->scan_char(value); }
+        basic_imemstream& operator>>(signed char& value)
+        { return this->scan_char(value); }
+        basic_imemstream& operator>>(unsigned char& value)
+        { return this->scan_char(value); }
+        basic_imemstream& operator>>(std::string& value)
+        { return this->scan_string(value); }
         basic_imemstream& operator>>(std::ios_base& (*func)(std::ios_base&))
         { return base::operator>>(func), *this; }
         basic_imemstream& operator>>(std::basic_ios<char_type>& (*func)(std::basic_ios<char_type>&))
         { return base::operator>>(func), *this; }
+
+    private:
+
+        // Prepares the stream for a input operation, skipping whitespaces if necessary (the work of a sentry)
+        // Returns the current position on the memory buffer or nullptr if the stream isn't ready for input
+        const char* scan_begin()
+        {
+            if(this->good())
+            {
+                const char* p = m_rdbuf.gcur();
+                if(this->flags() & std::ios_base::skipws)
+                    p = scanner::skip_spaces(p, m_rdbuf.gend());
+                m_rdbuf.gseek(p);
+
+                if(p != m_rdbuf.gend())
+                    return p;
+
+                this->setstate(std::ios_base::eofbit);
+            }
+            this->setstate(std::ios_base::failbit);
+            return nullptr;
+        }
+
+        // Finishes a input operation, 'p' is the end of the scanned token or nullptr if the scanning failed
+        basic_imemstream& scan_end(const char* p)
+        {
+            if(p == nullptr)
+                this->setstate(std::ios_base::failbit);
+            else
+            {
+                m_rdbuf.gseek(p);
+                if(p == m_rdbuf.gend()) this->setstate(std::ios_base::eofbit);
+            }
+            return *this;
+        }
+
+        // Checks whether the classified token at 'p' (if any) is known to not be of the specified kind
+        bool wrong_kind(const char* p, token_list::kind_type kind) const
+        {
+            auto token = m_tokens? m_tokens->at(p) : nullptr;
+            return token && !token->is(kind);
+        }
+
+        template<class T>
+        basic_imemstream& scan_integer(T& value)
+        {
+            if(auto p = scan_begin())
+            {
+                auto basefield = this->flags() & std::ios_base::basefield;
+                if((basefield == std::ios_base::dec || basefield == 0) && wrong_kind(p, token_list::integer))
+                    return scan_end(nullptr);
+                return scan_end(scanner::scan_integer(p, m_rdbuf.gend(), basefield, value));
+            }
+            return *this;
+        }
+
+        template<class T>
+        basic_imemstream& scan_real(T& value)
+        {
+            if(auto p = scan_begin())
+            {
+                if(wrong_kind(p, token_list::real))
+                    return scan_end(nullptr);
+                return scan_end(scanner::scan_real(p, m_rdbuf.gend(), value));
+            }
+            return *this;
+        }
+
+        basic_imemstream& scan_bool(bool& value)
+        {
+            if(auto p = scan_begin())
+            {
+                bool boolalpha = !!(this->flags() & std::ios_base::boolalpha);
+                if(!boolalpha && wrong_kind(p, token_list::boolean))
+                    return scan_end(nullptr);
+                return scan_end(scanner::scan_bool(p, m_rdbuf.gend(), boolalpha, value));
+            }
+            return *this;
+        }
+
+        template<class T>
+        basic_imemstream& scan_char(T& value)
+        {
+            if(auto p = scan_begin())
+                return scan_end(scanner::scan_char(p, m_rdbuf.gend(), value));
+            return *this;
+        }
+
+        basic_imemstream& scan_string(std::string& value)
+        {
+            if(auto p = scan_begin())
+            {
+                auto width = this->width(0);
+                return scan_end(scanner::scan_string(p, m_rdbuf.gend(), width, value));
+            }
+            this->width(0);
+            return *this;
+        }
+};
+
+
+/*
+ *  basic_omemstream
+ *      An ostream which appends to a std::string
+ */
+template<class CharT, class Traits>
+class basic_omemstream : public std::basic_ostream<CharT, Traits>
+{
+    private:
+        using base = std::basic_ostream<CharT, Traits>;
+        using typename base::char_type;
+
+        appendbuf m_rdbuf;
+        bool      m_classic;    // whether the locale is the classic one, so numbers can be formatted without the locale facets
+
+        template<class T>
+        using is_char = std::integral_constant<bool, std::is_same<T, char>::value || std::is_same<T, signed char>::value
+                                                  || std::is_same<T, unsigned char>::value || std::is_same<T, wchar_t>::value
+                                                  || std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value>;
+
+        template<class T>
+        using is_integer = std::integral_constant<bool, std::is_integral<T>::value && !is_char<T>::value && !std::is_same<T, bool>::value>;
+
+    public:
+        explicit basic_omemstream(std::string& str) :
+            base(&m_rdbuf), m_rdbuf(str)
+        {
+            this->m_classic = (this->getloc() == std::locale::classic());
+        }
+
+        // Returns pointer to the underlying raw string device object. 
+        appendbuf* rdbuf()
+        { return &m_rdbuf; }
+
+        basic_omemstream(const basic_omemstream&) = delete;
+        basic_omemstream(basic_omemstream&&) = delete;
+        basic_omemstream& operator=(const basic_omemstream&) = delete;
+        basic_omemstream& operator=(basic_omemstream&&) = delete;
+
+        // Arithmetic inserters
+        // Those format directly into the string when the stream is in it's default state (decimal, no width, no showpos, ...),
+        // giving the very same output the locale facets would give, otherwise they fall back to the base ostream.
+        // NOTE: Those are templates on purpose, so that characters, enumerations and types convertible to integers
+        //       keep going to their usual free inserters instead of being hijacked by a integer overload.
+        template<class T>
+        typename std::enable_if<is_integer<T>::value, basic_omemstream&>::type operator<<(T value)
+        { return this->print_integer(value); }
+        template<class T>
+        typename std::enable_if<std::is_floating_point<T>::value, basic_omemstream&>::type operator<<(T value)
+        { return this->print_real(value); }
+        template<class T>
+        typename std::enable_if<std::is_same<T, bool>::value, basic_omemstream&>::type operator<<(T value)
+        { return base::operator<<(value), *this; }
+        template<class T>
+        typename std::enable_if<!is_char<T>::value, basic_omemstream&>::type operator<<(const T* value)
+        { return base::operator<<(value), *this; }
+        basic_omemstream& operator<<(std::ios_base& (*func)(std::ios_base&))
+        { return base::operator<<(func), *this; }
+        basic_omemstream& operator<<(std::basic_ios<char_type>& (*func)(std::basic_ios<char_type>&))
+        { return base::operator<<(func), *this; }
+        basic_omemstream& operator<<(base& (*func)(base&))
+        { return base::operator<<(func), *this; }
+
+    private:
+
+        // Checks whether the stream is in a state where the numbers can be formatted by ourselves
+        bool is_plain(std::ios_base::fmtflags mask) const
+        {
+            return this->good() && this->m_classic && this->width() == 0 && (this->flags() & mask) == 0;
+        }
+
+        // Sign check which doesn't compare unsigned values against zero
+        template<class T>
+        static bool is_negative(T value, std::true_type)  { return value < 0; }
+        template<class T>
+        static bool is_negative(T, std::false_type)       { return false; }
+
+        template<class T>
+        basic_omemstream& print_integer(T value)
+        {
+            auto mask = std::ios_base::showpos | std::ios_base::oct | std::ios_base::hex;
+            if(!is_plain(mask))
+                return base::operator<<(value), *this;
+
+            char buf[24];
+            char* end = buf + sizeof(buf);
+            char* p   = end;
+
+            using unsigned_type = typename std::make_unsigned<T>::type;
+            bool negative = is_negative(value, std::is_signed<T>());
+            unsigned_type magnitude = (negative? unsigned_type(0 - unsigned_type(value)) : unsigned_type(value));
+            do { *--p = char('0' + (magnitude % 10)); } while(magnitude /= 10);
+            if(negative) *--p = '-';
+
+            m_rdbuf.string().append(p, end);
+            return *this;
+        }
+
+        template<class T>
+        basic_omemstream& print_real(T value)
+        {
+            auto mask = std::ios_base::showpos | std::ios_base::showpoint | std::ios_base::uppercase | std::ios_base::floatfield;
+            if(!is_plain(mask) || this->precision() <= 0)
+                return base::operator<<(value), *this;
+
+            char buf[64];
+            int len = std::snprintf(buf, sizeof(buf), "%.*Lg", int(this->precision()), (long double)(value));
+            if(len < 0 || len >= int(sizeof(buf)))
+                return base::operator<<(value), *this;
+
+            m_rdbuf.string().append(buf, std::size_t(len));
+            return *this;
+        }
 };
 
 
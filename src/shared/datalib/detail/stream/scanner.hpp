@@ -0,0 +1,350 @@
+/*
+ *  Copyright (C) 2015 Denilson das Merc�s Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <ios>
+#include <limits>
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace datalib {
+
+/*
+ *  scanner
+ *
+ *      Lightweight cursor based scanning over a character range [p, end), used as the I/O backend for data_info types
+ *      in both imemstream (reading) and icheckstream (checking).
+ *      No streambuf, locale or facet is touched, tokens are matched and converted directly from the memory buffer.
+ *
+ *      The acceptance rules are the same rules icheckstream always had:
+ *          [*] Integers: optional sign, optional base prefix (0x for hex, 0 for oct), at least one digit
+ *          [*] Reals:    optional sign, at least one digit, optional decimal point followed by optional digits, optional exponent
+ *          [*] Booleans: '0'/'1' or 'true'/'false' when boolalpha is set
+ *          [*] Every token must be followed by a separator (blank space or the end of the range)
+ *
+ *      The match_* functions only validate, the scan_* functions validate and convert at once.
+ *      Each of them returns a pointer to the end of the token (the separator isn't consumed) or nullptr on failure.
+ */
+struct scanner
+{
+    // Fast check for space characters
+    static bool isspace(int c)
+    {
+        return (c == 0x20) || (c >= 0x09 && c <= 0x0D);
+    }
+
+    // Fast check for integral digits
+    static bool isdigit(int c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Fast check for octal digits
+    static bool isodigit(int c)
+    {
+        return c >= '0' && c <= '7';
+    }
+
+    // Gets the value of the hexadecimal digit 'c' or -1 if it isn't a hexadecimal digit
+    static int xdigit_value(int c)
+    {
+        if(c >= '0' && c <= '9') return c - '0';
+        c |= 0x20;  // to lower case
+        if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    // Checks whether 'p' points to a separator (blank space or the end of the range)
+    static bool is_separator(const char* p, const char* end)
+    {
+        return p == end || isspace((unsigned char)(*p));
+    }
+
+    // Skips blank spaces
+    static const char* skip_spaces(const char* p, const char* end)
+    {
+        while(p != end && isspace((unsigned char)(*p))) ++p;
+        return p;
+    }
+
+    // Finds the end of the current token (the next blank space or the end of the range)
+    static const char* find_separator(const char* p, const char* end)
+    {
+        while(p != end && !isspace((unsigned char)(*p))) ++p;
+        return p;
+    }
+
+
+    //
+    //  Matchers
+    //
+
+    // Matches an integer in the base specified by 'basefield' (std::ios::basefield flags)
+    static const char* match_integer(const char* p, const char* end, std::ios::fmtflags basefield)
+    {
+        bool negative; unsigned long long magnitude;
+        return scan_magnitude(p, end, basefield, negative, magnitude, nullptr);
+    }
+
+    // Matches a real number (supports exponents)
+    static const char* match_real(const char* p, const char* end)
+    {
+        p = match_real_body(p, end);
+        return (p && is_separator(p, end))? p : nullptr;
+    }
+
+    // Matches a boolean 'true'/'false' or '1'/'0', depending on 'boolalpha'
+    static const char* match_bool(const char* p, const char* end, bool boolalpha)
+    {
+        bool dummy;
+        return scan_bool(p, end, boolalpha, dummy);
+    }
+
+    // Matches a single character
+    static const char* match_char(const char* p, const char* end)
+    {
+        return (p != end && is_separator(p + 1, end))? p + 1 : nullptr;
+    }
+
+    // Matches a string of at most 'count' characters
+    static const char* match_string(const char* p, const char* end, std::streamsize count)
+    {
+        if(count > 0 && end - p > count) end = p + count;
+        p = find_separator(p, end);
+        return p;
+    }
+
+
+    //
+    //  Scanners
+    //
+
+    // Scans an integer in the base specified by 'basefield' (std::ios::basefield flags)
+    // Out of range values fail to be scanned (just like a istream would do)
+    template<class T>
+    static const char* scan_integer(const char* p, const char* end, std::ios::fmtflags basefield, T& value)
+    {
+        static_assert(std::is_integral<T>::value, "scan_integer requires an integral type");
+        using unsigned_type = typename std::make_unsigned<T>::type;
+
+        bool negative; unsigned long long magnitude; bool overflow = false;
+        if((p = scan_magnitude(p, end, basefield, negative, magnitude, &overflow)) && !overflow)
+        {
+            if(std::is_signed<T>::value)
+            {
+                auto limit = (unsigned long long)((std::numeric_limits<T>::max)()) + (negative? 1 : 0);
+                if(magnitude > limit) return nullptr;
+                value = negative? T(0 - unsigned_type(magnitude)) : T(magnitude);
+            }
+            else
+            {
+                // negative unsigned integers wrap around, as strtoul does
+                if(magnitude > (unsigned long long)((std::numeric_limits<T>::max)())) return nullptr;
+                value = negative? T(0 - unsigned_type(magnitude)) : T(magnitude);
+            }
+            return p;
+        }
+        return nullptr;
+    }
+
+    // Scans a real number (supports exponents)
+    // The token is validated by the real matcher and then converted by strtod, which is what the istream does behind the scenes
+    template<class T>
+    static const char* scan_real(const char* p, const char* end, T& value)
+    {
+        static_assert(std::is_floating_point<T>::value, "scan_real requires a floating point type");
+
+        const char* token_end = match_real(p, end);
+        if(token_end)
+        {
+            char  stkbuf[64];
+            std::string heapbuf;
+            const char* str;
+            auto len = size_t(token_end - p);
+
+            if(len < sizeof(stkbuf))
+            {
+                std::memcpy(stkbuf, p, len);
+                stkbuf[len] = 0;
+                str = stkbuf;
+            }
+            else
+            {
+                heapbuf.assign(p, token_end);
+                str = heapbuf.c_str();
+            }
+
+            errno = 0;
+            T result = strtox(str, (T*)(nullptr));
+            if(errno == ERANGE && (result > T(1) || result < T(-1)))  // overflow fails, underflow goes towards zero
+                return nullptr;
+
+            value = result;
+            return token_end;
+        }
+        return nullptr;
+    }
+
+    // Scans a boolean 'true'/'false' or '1'/'0', depending on 'boolalpha'
+    static const char* scan_bool(const char* p, const char* end, bool boolalpha, bool& value)
+    {
+        if(boolalpha)
+        {
+            // Only accepts 'true' and 'false', not 'TRUE' and 'FALSE'
+            if(end - p >= 4 && !std::memcmp(p, "true", 4))
+                value = true, p += 4;
+            else if(end - p >= 5 && !std::memcmp(p, "false", 5))
+                value = false, p += 5;
+            else
+                return nullptr;
+        }
+        else
+        {
+            if(p != end && (*p == '0' || *p == '1'))
+                value = (*p++ == '1');
+            else
+                return nullptr;
+        }
+        return is_separator(p, end)? p : nullptr;
+    }
+
+    // Scans a single character
+    template<class CharT>
+    static const char* scan_char(const char* p, const char* end, CharT& value)
+    {
+        if(auto q = match_char(p, end))
+        {
+            value = CharT(*p);
+            return q;
+        }
+        return nullptr;
+    }
+
+    // Scans a string of at most 'count' characters
+    template<class Traits, class Allocator>
+    static const char* scan_string(const char* p, const char* end, std::streamsize count, std::basic_string<char, Traits, Allocator>& str)
+    {
+        auto q = match_string(p, end, count);
+        if(q != p)
+        {
+            str.assign(p, q);
+            return q;
+        }
+        return nullptr;
+    }
+
+
+    private:
+
+        static float strtox(const char* str, float*)             { return std::strtof(str, nullptr); }
+        static double strtox(const char* str, double*)           { return std::strtod(str, nullptr); }
+        static long double strtox(const char* str, long double*) { return std::strtold(str, nullptr); }
+
+        // Matches a sequence of (at least one) digits, 'isdigit' tells whether the character is a valid digit
+        template<class IsDigitFunctor>
+        static const char* match_digits(const char* p, const char* end, IsDigitFunctor isdigit)
+        {
+            if(p == end || !isdigit((unsigned char)(*p)))
+                return nullptr;
+            for(++p; p != end && isdigit((unsigned char)(*p)); ++p) {}
+            return p;
+        }
+
+        // Matches the real number grammar without checking for the separator
+        static const char* match_real_body(const char* p, const char* end)
+        {
+            auto fdigit = [](int c) { return isdigit(c); };
+
+            if(p != end && (*p == '+' || *p == '-')) ++p;
+            if((p = match_digits(p, end, fdigit)) == nullptr)
+                return nullptr;
+
+            // After the initial integer, we can have either a decimal point or exponent
+            // We cannot have another decimal after a decimal or after a exponent
+            if(p != end && *p == '.')
+            {
+                ++p;
+                if(p != end && isdigit((unsigned char)(*p)))
+                    p = match_digits(p, end, fdigit);
+            }
+
+            if(p != end && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                if(p != end && (*p == '+' || *p == '-')) ++p;
+                p = match_digits(p, end, fdigit);
+            }
+
+            return p;
+        }
+
+        // Scans the sign and magnitude of an integer in the base specified by 'basefield'
+        // If 'overflow' is null the magnitude isn't computed (matching only)
+        static const char* scan_magnitude(const char* p, const char* end, std::ios::fmtflags basefield,
+                                          bool& negative, unsigned long long& magnitude, bool* overflow)
+        {
+            negative = false;
+            magnitude = 0;
+
+            if(p != end && (*p == '+' || *p == '-'))
+                negative = (*p++ == '-');
+
+            if(basefield & std::ios::hex)
+            {
+                // Hexadecimal fast path, skips the '0x' prefix and accumulates nibbles
+                if(end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+                    p += 2;
+
+                const char* first = p;
+                for(int d; p != end && (d = xdigit_value((unsigned char)(*p))) >= 0; ++p)
+                {
+                    if(overflow)
+                    {
+                        if(magnitude >> 60) *overflow = true;
+                        magnitude = (magnitude << 4) | unsigned(d);
+                    }
+                }
+                if(p == first) return nullptr;
+            }
+            else if(basefield & std::ios::oct)
+            {
+                const char* first = p;
+                if(p != end && *p == '0') ++p;  // the leading zero is a digit by itself
+
+                for(; p != end && isodigit((unsigned char)(*p)); ++p)
+                {
+                    if(overflow)
+                    {
+                        if(magnitude >> 61) *overflow = true;
+                        magnitude = (magnitude << 3) | unsigned(*p - '0');
+                    }
+                }
+                if(p == first) return nullptr;
+            }
+            else
+            {
+                const char* first = p;
+                for(; p != end && isdigit((unsigned char)(*p)); ++p)
+                {
+                    if(overflow)
+                    {
+                        unsigned d = unsigned(*p - '0');
+                        if(magnitude > ((std::numeric_limits<unsigned long long>::max)() - d) / 10)
+                            *overflow = true;
+                        magnitude = magnitude * 10 + d;
+                    }
+                }
+                if(p == first) return nullptr;
+            }
+
+            return is_separator(p, end)? p : nullptr;
+        }
+};
+
+
+} // namespace datalib
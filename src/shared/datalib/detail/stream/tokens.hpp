@@ -0,0 +1,170 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#pragma once
+#include <ios>
+#include <string>
+#include <cstddef>
+#include <type_traits>
+#include <datalib/detail/stream/scanner.hpp>
+
+namespace datalib {
+
+/*
+ *  token_list
+ *
+ *      Tokenizes a line once into an array of token spans, each with a classified kind (integer, real, boolean, identifier).
+ *      The check and input streams consult this array when it's available, so alternatives (either<>, optional<>, delimopt)
+ *      that keep rewinding the stream do not rescan and reclassify the same tokens over and over.
+ *      A token is classified the first time it's looked at, tokens no one looks at cost only the span.
+ *
+ *      Only the first 'capacity' tokens are stored (lines longer than that are unusual), tokens past it still count on count()
+ *      but aren't classified, streams fall back to the scanner on them.
+ */
+class token_list
+{
+    public:
+        static const std::size_t capacity = 64;
+
+        // Token kinds, a token may be of more than one kind (e.g. '1' is a boolean, an integer and a real)
+        enum kind_type : unsigned char
+        {
+            integer     = 0x01,     // decimal integer (see scanner::match_integer)
+            real        = 0x02,     // real number (see scanner::match_real)
+            boolean     = 0x04,     // '0' or '1' (see scanner::match_bool without boolalpha)
+            identifier  = 0x08,     // starts with a letter or underscore
+        };
+
+        struct token
+        {
+            const char*             begin;
+            const char*             end;
+            mutable unsigned char   kind;   // kind_type flags, or 'unclassified'
+
+            bool is(kind_type k) const
+            {
+                if(kind == unclassified) kind = classify(begin, end);
+                return (kind & k) != 0;
+            }
+        };
+
+    public:
+        token_list(const char* p, const char* end) :
+            m_count(0), m_stored(0), m_cursor(0)
+        {
+            this->tokenize(p, end);
+        }
+
+        explicit token_list(const std::string& str) :
+            token_list(str.data(), str.data() + str.size())
+        {}
+
+        token_list(const token_list&) = delete;
+        token_list& operator=(const token_list&) = delete;
+
+        // Number of tokens in the line
+        std::size_t count() const
+        { return m_count; }
+
+        // Gets the token starting at 'p' or nullptr if there's no known token starting there
+        const token* at(const char* p) const
+        {
+            // Streams go forward most of the time, so try the last position and the one after it before searching
+            if(m_cursor < m_stored && m_tokens[m_cursor].begin == p)
+                return &m_tokens[m_cursor];
+            if(m_cursor + 1 < m_stored && m_tokens[m_cursor + 1].begin == p)
+                return &m_tokens[++m_cursor];
+
+            auto i = lower_bound(p);
+            if(i < m_stored && m_tokens[i].begin == p)
+                return &m_tokens[m_cursor = i];
+            return nullptr;
+        }
+
+        // Number of tokens starting at or after 'p'
+        // When 'p' is past the stored tokens the result is an upper bound
+        std::size_t remaining(const char* p) const
+        {
+            return m_count - lower_bound(p);
+        }
+
+    private:
+        static const unsigned char unclassified = 0xFF;
+
+        void tokenize(const char* p, const char* end)
+        {
+            for(p = scanner::skip_spaces(p, end); p != end; p = scanner::skip_spaces(p, end))
+            {
+                const char* q = scanner::find_separator(p, end);
+                if(m_stored < capacity)
+                    m_tokens[m_stored++] = token { p, q, unclassified };
+                ++m_count;
+                p = q;
+            }
+        }
+
+        // Classifies the token [p, end), which is always followed by a separator
+        static unsigned char classify(const char* p, const char* end)
+        {
+            unsigned char kind = 0;
+            int c = (unsigned char)(*p);
+            if(scanner::isdigit(c) || c == '+' || c == '-')
+            {
+                if(scanner::match_integer(p, end, std::ios::dec)) kind |= integer;
+                if(scanner::match_real(p, end))                   kind |= real;
+                if(scanner::match_bool(p, end, false))            kind |= boolean;
+            }
+            else if(c == '_' || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z'))
+            {
+                kind |= identifier;
+            }
+            return kind;
+        }
+
+        // Finds the index of the first stored token starting at or after 'p'
+        std::size_t lower_bound(const char* p) const
+        {
+            std::size_t first = 0, len = m_stored;
+            while(len > 0)
+            {
+                std::size_t half = len / 2;
+                if(m_tokens[first + half].begin < p)
+                    first += half + 1, len -= half + 1;
+                else
+                    len = half;
+            }
+            return first;
+        }
+
+    private:
+        std::size_t         m_count;            // number of tokens in the line
+        std::size_t         m_stored;           // number of tokens stored in 'm_tokens'
+        mutable std::size_t m_cursor;           // index of the last token found by at()
+        token               m_tokens[capacity];
+};
+
+
+/*
+ *  min_tokens
+ *      The minimum number of tokens an input of the type T consumes
+ *      Used to fail fast when there aren't enough tokens left in the line to even try the input of T.
+ *      Types which aren't known to consume anything must keep the zero (the default), since a wrong guess makes a valid input fail.
+ *      Specialize it along with the I/O operators of the type.
+ */
+template<class T, typename = void>
+struct min_tokens : std::integral_constant<std::size_t, 0>
+{};
+
+template<class T>
+struct min_tokens<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
+    : std::integral_constant<std::size_t, 1>
+{};
+
+template<class CharT, class Traits, class Allocator>
+struct min_tokens<std::basic_string<CharT, Traits, Allocator>> : std::integral_constant<std::size_t, 1>
+{};
+
+
+} // namespace datalib
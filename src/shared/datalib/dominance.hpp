@@ -5,16 +5,410 @@
  */
 #pragma once
 #include <algorithm>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <datalib/data_info.hpp>
 #include <datalib/detail/flat_linear_map.hpp>
+#include <datalib/detail/ordered_hash_set.hpp>
 
 namespace datalib {
 
+// Number of elements (summed over all the storers) from which merge_dominant_data runs in parallel
+#ifndef DATALIB_DOMINANCE_PARALLEL_THRESHOLD
+#   define DATALIB_DOMINANCE_PARALLEL_THRESHOLD 65536
+#endif
+
 // If the key do not exist in at least one custom store BUT exists in the default store, just remove the value (return null)
 static const int flag_RemoveIfNotExistInOneCustomButInDefault   = 0x0001; 
 // If the key do not exist in any of the custom store, remove the value (return null)
 static const int flag_RemoveIfNotExistInAnyCustom               = 0x0002;
 
 
+namespace detail
+{
+    /*
+     *  fingerprinted_ref
+     *      Reference to a element along with it's fingerprint (see data_hash), used to compare elements cheaply.
+     *      The full comparision only happens when the fingerprints match.
+     */
+    template<typename T>
+    struct fingerprinted_ref
+    {
+        std::size_t               fingerprint;
+        std::reference_wrapper<T> ref;
+
+        fingerprinted_ref(T& value) :
+            fingerprint(hash_data(value)), ref(value)
+        {}
+
+        bool operator==(const fingerprinted_ref& rhs) const
+        {
+            return this->fingerprint == rhs.fingerprint && this->ref.get() == rhs.ref.get();
+        }
+    };
+
+    /*
+     *  find_dominant_in_group
+     *      Finds the dominant element in a group of values of the same key, where values[i] is the value in stores[i] (or null if not present)
+     *      Implements the rules documented in find_dominant_data.
+     */
+    template<typename StoreType> inline
+    auto find_dominant_in_group(StoreType* const* stores, typename StoreType::mapped_type* const* values, std::size_t nstores, int flags) ->
+        typename StoreType::mapped_type*
+    {
+        using mapped_type = typename StoreType::mapped_type;
+
+        // must store the key-value pairs in the same order as they were inserted because of the rule of this algorithm
+        // that if many different elements are present the first found is returned
+        using map_counter_type = flat_linear_map<
+                                    fingerprinted_ref<mapped_type>,         // ref to the element and it's fingerprint, so most unequal elements aren't fully compared
+                                    std::pair<uint32_t, bool>               // .first is quantity, .second tells whether the element is present in the default store
+                                   >; 
+
+        map_counter_type counter;
+        bool has_any_custom         = false;    // Whether there's any element from a custom store in the first-last range of storers
+        bool key_isnt_in_one_custom = false;    // Whether the element has not been found in at least one custom storer
+        bool key_is_in_default      = false;    // Whether the element is present in the default storer
+
+        for(std::size_t i = 0; i < nstores; ++i)
+        {
+            bool is_default = stores[i]->is_default_store();
+
+            if(stores[i]->ready())
+            {
+                has_any_custom |= !is_default;
+
+                if(values[i] != nullptr)
+                {
+                    auto& count = counter[fingerprinted_ref<mapped_type>(*values[i])];
+                    ++count.first;
+                    count.second |= is_default;
+                    key_is_in_default |= is_default;
+                }
+                else
+                {
+                    if(is_default == false)
+                    {
+                        key_isnt_in_one_custom = true;
+                        if(flags & flag_RemoveIfNotExistInAnyCustom)
+                            return nullptr;
+                    }
+                }
+            }
+        }
+
+        if(counter.size())
+        {
+            if(flags & flag_RemoveIfNotExistInOneCustomButInDefault)
+            {
+                if(has_any_custom)
+                {
+                    if(key_is_in_default && key_isnt_in_one_custom)
+                        return nullptr;
+                }
+            }
+
+            // Find the dominant based on the information gathered in the iteration over there
+            // Remember the 'if all elements are dominant, the first one is returned'? well, std::min_element has this rule too :)
+            auto dom = std::min_element(counter.begin(), counter.end(), [](const typename map_counter_type::value_type& a, const typename map_counter_type::value_type& b)
+            {
+                // Because the dominant element cannot be the default one, returns 'a' if 'b' is default and returns 'b' if 'a' is the default.
+                // Otherwise returns the less commmon element, which should be the dominant.
+                auto &av = a.second, &bv = b.second;
+                return ((av.second || bv.second)? bv.second : (av.first < bv.first));
+            });
+
+            return (dom != counter.end()? &dom->first.ref.get() : nullptr);
+        }
+
+        return nullptr;
+    }
+
+    /*
+     *  parallel_for_blocks
+     *      Splits [0, count) in 'nblocks' contiguous blocks and runs 'fn(begin, end)' for each of them in its own thread.
+     *      The calling thread takes the first block (and any block whose thread couldn't be created).
+     *      Exceptions thrown by 'fn' are rethrown in the calling thread after all the blocks are done.
+     */
+    template<typename Fn> inline
+    void parallel_for_blocks(std::size_t count, std::size_t nblocks, Fn& fn)
+    {
+        std::vector<std::exception_ptr> errors(nblocks);
+        std::vector<std::thread> workers;
+        workers.reserve(nblocks);
+
+        auto run_block = [&](std::size_t b)
+        {
+            try
+            {
+                fn(count * b / nblocks, count * (b + 1) / nblocks);
+            }
+            catch(...)
+            {
+                errors[b] = std::current_exception();
+            }
+        };
+
+        std::size_t b = 1;
+        try
+        {
+            for(; b < nblocks; ++b)
+                workers.emplace_back(run_block, b);
+        }
+        catch(const std::system_error&)
+        {
+            // Out of threads, the blocks left run here
+        }
+
+        run_block(0);
+        for(; b < nblocks; ++b) run_block(b);
+        for(auto& worker : workers) worker.join();
+
+        for(auto& error : errors)
+        {
+            if(error) std::rethrow_exception(error);
+        }
+    }
+
+    // Finds how many threads should merge 'nkeys' keys made of 'nentries' elements (one means a serial merge)
+    inline std::size_t merge_workers(std::size_t nkeys, std::size_t nentries)
+    {
+        static const std::size_t min_keys_per_worker = 1024;
+        if(nentries < DATALIB_DOMINANCE_PARALLEL_THRESHOLD)
+            return 1;
+        std::size_t hw = std::thread::hardware_concurrency();
+        return (std::max)(std::size_t(1), (std::min)(hw, nkeys / min_keys_per_worker));
+    }
+
+    /*
+     *  merge_dominant_groups
+     *      Parallel merge over 'nkeys' groups of elements, each group being the elements of a key in the storers.
+     *      The keys are split in contiguous blocks, one for each worker, and the dominant elements are output afterwards in the keys order,
+     *      so the output is the same a serial merge gives.
+     *
+     *      key_at(k)               -> Gets the key of the group k
+     *      fill_values(k, values)  -> Puts in values[i] the element of the group k in stores[i] (or null if not present)
+     */
+    template<typename StoreType, typename KeyAt, typename FillValues, typename DomFlags, typename Output> inline
+    void merge_dominant_groups(const std::vector<StoreType*>& stores, std::size_t nkeys, std::size_t nworkers,
+                               KeyAt& key_at, FillValues& fill_values, DomFlags& domflags, Output& output)
+    {
+        using mapped_type = typename StoreType::mapped_type;
+
+        std::vector<mapped_type*> dominant(nkeys);
+        auto find_block = [&](std::size_t begin, std::size_t end)
+        {
+            std::vector<mapped_type*> values(stores.size());
+            for(std::size_t k = begin; k < end; ++k)
+            {
+                fill_values(k, values);
+                dominant[k] = find_dominant_in_group(stores.data(), values.data(), stores.size(), domflags(key_at(k)));
+            }
+        };
+
+        parallel_for_blocks(nkeys, nworkers, find_block);
+
+        for(std::size_t k = 0; k < nkeys; ++k)
+        {
+            if(dominant[k] != nullptr)
+                output(key_at(k), *dominant[k]);
+        }
+    }
+
+    /*
+     *  merge_dominant_data
+     *      Sorted containers, k-way merge over the iterators of each container.
+     *      On large merges the groups are gathered and their dominant elements found in parallel (see merge_dominant_groups).
+     */
+    template<typename StoreType, typename DomFlags, typename Output> inline
+    void merge_dominant_data(std::true_type, const std::vector<StoreType*>& stores, DomFlags& domflags, Output& output)
+    {
+        using container_type = typename StoreType::container_type;
+        using iterator       = decltype(std::declval<container_type&>().begin());
+        using key_type       = typename StoreType::key_type;
+        using mapped_type    = typename StoreType::mapped_type;
+
+        if(stores.empty())
+            return;
+
+        std::size_t nentries = 0, nkeys_max = 0;
+        for(auto* store : stores)
+        {
+            if(store->ready())
+            {
+                nentries += store->container().size();
+                nkeys_max = (std::max)(nkeys_max, store->container().size());
+            }
+        }
+
+        // The elements of each key, in store order, used only by the parallel merge
+        std::size_t nworkers = merge_workers(nkeys_max, nentries);
+        std::vector<const key_type*> keys;
+        std::vector<std::size_t> groups;                                // first entry of each key, plus the end of the last key
+        std::vector<std::pair<std::size_t, mapped_type*>> entries;      // the store and element of each entry
+        if(nworkers > 1)
+        {
+            keys.reserve(nkeys_max);
+            groups.reserve(nkeys_max + 1);
+            entries.reserve(nentries);
+        }
+
+        auto comp = stores.front()->container().key_comp();
+
+        std::vector<std::pair<iterator, iterator>> cursors;     // current position and end of each store
+        std::vector<mapped_type*> values(stores.size());        // values of the current key in each store
+        for(auto* store : stores)
+        {
+            auto& map = store->container();
+            cursors.emplace_back(store->ready()? map.begin() : map.end(), map.end());
+        }
+
+        while(true)
+        {
+            // Find the smallest key among the cursors, the first store with it owns the key reference
+            const typename StoreType::key_type* key = nullptr;
+            for(auto& cur : cursors)
+            {
+                if(cur.first != cur.second && (key == nullptr || comp(cur.first->first, *key)))
+                    key = &cur.first->first;
+            }
+
+            if(key == nullptr)
+                break;
+
+            // Take the values of the key from each store and step forward
+            for(std::size_t i = 0; i < cursors.size(); ++i)
+            {
+                auto& cur = cursors[i];
+                values[i] = nullptr;
+                if(cur.first != cur.second && !comp(*key, cur.first->first))
+                {
+                    values[i] = &cur.first->second;
+                    do ++cur.first; while(cur.first != cur.second && !comp(*key, cur.first->first));
+                }
+            }
+
+            if(nworkers > 1)
+            {
+                keys.emplace_back(key);
+                groups.emplace_back(entries.size());
+                for(std::size_t i = 0; i < values.size(); ++i)
+                {
+                    if(values[i] != nullptr)
+                        entries.emplace_back(i, values[i]);
+                }
+            }
+            else if(auto* vdom = find_dominant_in_group(stores.data(), values.data(), stores.size(), domflags(*key)))
+                output(*key, *vdom);
+        }
+
+        if(nworkers > 1)
+        {
+            groups.emplace_back(entries.size());
+
+            auto key_at = [&](std::size_t k) -> const key_type& { return *keys[k]; };
+            auto fill_values = [&](std::size_t k, std::vector<mapped_type*>& values)
+            {
+                std::fill(values.begin(), values.end(), nullptr);
+                for(std::size_t e = groups[k]; e != groups[k + 1]; ++e)
+                    values[entries[e].first] = entries[e].second;
+            };
+
+            merge_dominant_groups(stores, keys.size(), nworkers, key_at, fill_values, domflags, output);
+        }
+    }
+
+    /*
+     *  merge_dominant_data
+     *      Unsorted containers, hash join over the keys of all containers.
+     *      On large merges the dominant elements of the joined keys are found in parallel (see merge_dominant_groups).
+     */
+    template<typename StoreType, typename DomFlags, typename Output> inline
+    void merge_dominant_data(std::false_type, const std::vector<StoreType*>& stores, DomFlags& domflags, Output& output)
+    {
+        using key_type    = typename StoreType::key_type;
+        using mapped_type = typename StoreType::mapped_type;
+
+        struct key_hasher
+        {
+            std::size_t operator()(const key_type& key) const { return hash_data(key); }
+        };
+
+        struct key_equal
+        {
+            bool operator()(const key_type& a, const key_type& b) const { return (a == b); }
+        };
+
+        // A element found in a store, those are linked by key in store order
+        struct entry_type
+        {
+            std::size_t  store;
+            mapped_type* value;
+            std::size_t  next;
+        };
+
+        static const std::size_t npos = std::size_t(-1);
+
+        ordered_hash_set<std::reference_wrapper<const key_type>, key_hasher, key_equal> keys;
+        std::vector<std::pair<std::size_t, std::size_t>> links;     // first and last entry of each key
+        std::vector<entry_type> entries;
+
+        for(std::size_t i = 0; i < stores.size(); ++i)
+        {
+            if(stores[i]->ready())
+            {
+                for(auto& kv : stores[i]->container())
+                {
+                    auto it = keys.insert(std::cref(kv.first));
+                    auto k  = std::size_t(it.first - keys.begin());
+
+                    if(it.second)
+                        links.emplace_back(npos, npos);
+                    else if(entries[links[k].second].store == i)
+                        continue;   // only the first element of a key in a store counts, just like a find would do
+
+                    entry_type entry = { i, &kv.second, npos };
+                    entries.emplace_back(entry);
+
+                    auto& link = links[k];
+                    if(link.first == npos)
+                        link.first = entries.size() - 1;
+                    else
+                        entries[link.second].next = entries.size() - 1;
+                    link.second = entries.size() - 1;
+                }
+            }
+        }
+
+        auto key_at = [&](std::size_t k) -> const key_type& { return keys.begin()[k].get(); };
+        auto fill_values = [&](std::size_t k, std::vector<mapped_type*>& values)
+        {
+            std::fill(values.begin(), values.end(), nullptr);
+            for(auto e = links[k].first; e != npos; e = entries[e].next)
+                values[entries[e].store] = entries[e].value;
+        };
+
+        std::size_t nworkers = merge_workers(keys.size(), entries.size());
+        if(nworkers > 1)
+        {
+            merge_dominant_groups(stores, keys.size(), nworkers, key_at, fill_values, domflags, output);
+            return;
+        }
+
+        std::vector<mapped_type*> values(stores.size());
+        for(std::size_t k = 0; k < keys.size(); ++k)
+        {
+            fill_values(k, values);
+
+            const key_type& key = key_at(k);
+            if(auto* vdom = find_dominant_in_group(stores.data(), values.data(), stores.size(), domflags(key)))
+                output(key, *vdom);
+        }
+    }
+}
+
 /*
  *  find_dominant_data
  *      This algorithm finds the dominant element at a specific key in a bunch of storers objects
@@ -63,73 +457,47 @@ auto find_dominant_data(ForwardIterator first, ForwardIterator last, const Key&
         return nullptr;
     }
 
-    // must store the key-value pairs in the same order as they were inserted because of the rule of this algorithm
-    // that if many different elements are present the first found is returned
-    using map_counter_type = flat_linear_map<
-                                std::reference_wrapper<mapped_type>,    // ref to the element; must be a ref because of the implicit conversion into 'type&'
-                                std::pair<uint32_t, bool>,              // .first is quantity, .second tells whether the element is present in the default store
-                                std::equal_to<mapped_type>              // pred for the key, remember about the implicit conversion?
-                               >; 
-
-    map_counter_type counter;
-    bool has_any_custom         = false;    // Whether there's any element from a custom store in the first-last range of storers
-    bool key_isnt_in_one_custom = false;    // Whether the element has not been found in at least one custom storer
-    bool key_is_in_default      = false;    // Whether the element is present in the default storer
-
+    std::vector<store_type*> stores;
+    std::vector<mapped_type*> values;
     for(auto st = first; st != last; ++st)
     {
-        bool is_default = st->default();
-
-        if(st->ready())
-        {
-            has_any_custom |= !is_default;
-
-            auto& map = st->container();
-            auto kv = map.find(key);
-            if(kv != map.end())
-            {
-                auto& count = counter[std::ref(kv->second)];
-                ++count.first;
-                count.second |= is_default;
-                key_is_in_default |= is_default;
-            }
-            else
-            {
-                if(is_default == false)
-                {
-                    key_isnt_in_one_custom = true;
-                    if(flags & flag_RemoveIfNotExistInAnyCustom)
-                        return nullptr;
-                }
-            }
-        }
+        auto& map = st->container();
+        auto kv = (st->ready()? map.find(key) : map.end());
+        stores.emplace_back(&(*st));
+        values.emplace_back(kv != map.end()? &kv->second : nullptr);
     }
 
-    if(counter.size())
-    {
-        if(flags & flag_RemoveIfNotExistInOneCustomButInDefault)
-        {
-            if(has_any_custom)
-            {
-                if(key_is_in_default && key_isnt_in_one_custom)
-                    return nullptr;
-            }
-        }
+    return detail::find_dominant_in_group(stores.data(), values.data(), stores.size(), flags);
+}
 
-        // Find the dominant based on the information gathered in the iteration over there
-        // Remember the 'if all elements are dominant, the first one is returned'? well, std::min_element has this rule too :)
-        auto dom = std::min_element(counter.begin(), counter.end(), [](const map_counter_type::value_type& a, const map_counter_type::value_type& b)
-        {
-            // Because the dominant element cannot be the default one, returns 'a' if 'b' is default and returns 'b' if 'a' is the default.
-            // Otherwise returns the less commmon element, which should be the dominant.
-            auto &av = a.second, &bv = b.second;
-            return ((av.second || bv.second)? bv.second : (av.first < bv.first));
-        });
+/*
+ *  merge_dominant_data
+ *      Finds the dominant element (see find_dominant_data) of every key present in a bunch of storers in a single pass.
+ *      Calls 'output(key, value)' for each key which has a dominant element.
+ *
+ *      first, last -> The range of storers to merge
+ *      domflags    -> Functor which returns the flags (see find_dominant_data) to be used in a specific key
+ *      output      -> Functor receiving the key and the dominant element, both as references to the objects in the storers
+ *
+ *      Sorted containers are walked in lock-step (a k-way merge over their iterators), giving the keys in sorted order.
+ *      Other containers are joined by a hash index on their keys (see data_hash), giving the keys in the order they first appear.
+ *      Either way, no lookup is performed in the containers.
+ *
+ *      When the storers hold at least DATALIB_DOMINANCE_PARALLEL_THRESHOLD elements, the dominant elements are found by worker threads,
+ *      each taking a contiguous block of keys. The output happens in the calling thread, in the very same order of a serial merge.
+ *      In this case 'domflags' is called concurrently and the data_hash/equality of the elements must be safe to run on different
+ *      elements at the same time.
+ */
+template<typename ForwardIterator, typename DomFlags, typename Output> inline
+void merge_dominant_data(ForwardIterator first, ForwardIterator last, DomFlags domflags, Output output)
+{
+    using store_type = typename std::decay<decltype(*first)>::type;
 
-        return (dom != counter.end()? &dom->first.get() : nullptr);
-    }
+    std::vector<store_type*> stores;
+    for(auto st = first; st != last; ++st)
+        stores.emplace_back(&(*st));
 
-    return nullptr;
+    return detail::merge_dominant_data(std::integral_constant<bool, store_type::is_sorted>(), stores, domflags, output);
 }
 
 template<int Flags>
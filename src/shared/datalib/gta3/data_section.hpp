@@ -7,11 +7,39 @@
 #include <utility>
 #include <string>
 #include <array>
+#include <deque>
+#include <mutex>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <type_traits>
+#include <boost/utility/string_ref.hpp>
 #include <datalib/detail/either.hpp>
+#include <datalib/data_info/either.hpp>
 
 namespace datalib {
 namespace gta3 {
 
+/*
+ *  section_index
+ *      Lookup table for a array of section_info's, dispatching on the first character of the section name.
+ *      Built by gta3::make_section_info, so finding the section of a line doesn't need to string compare against every section.
+ */
+struct section_index
+{
+    short head[256];    // Index of the first section whose name starts with the character, or -1 if none
+
+    // Keeps a copy of 'index' for the whole lifetime of the program, section arrays are static as well
+    static const section_index* keep(const section_index& index)
+    {
+        static std::mutex               mutex;
+        static std::deque<section_index> list;  // never moves its elements on push_back
+        std::lock_guard<std::mutex> lock(mutex);
+        list.push_back(index);
+        return &list.back();
+    }
+};
+
 /*
  *  section_info
  *      Represents a gta3 section
@@ -23,13 +51,25 @@ struct section_info
     const char* name;   // The name of this section. How it will be indentified in the sectioned file
     int         id;     // The index of this section in the sections array
     size_t      len;    // The length of the name
+    short       next;   // The index of the next section whose name starts with the same character as this, or -1 if none
+    const section_index* index; // The lookup table of the array this section is in (set by make_section_info)
 
     section_info() : section_info(nullptr) {}
-    section_info(const char* name) : name(name), id(-1), len(name? strlen(name) : 0) {}
+    section_info(const char* name) : name(name), id(-1), len(name? strlen(name) : 0), next(-1), index(nullptr) {}
 
     // Finds the a section_info object in the 'sections' array based on the specified name.
     static const section_info* by_name(const section_info* sections, const char* line)
     {
+        if(sections->index)
+        {
+            for(int i = sections->index->head[(unsigned char)(line[0])]; i != -1; i = sections[i].next)
+            {
+                if(!strcmp(line, sections[i].name))
+                    return &sections[i];
+            }
+            return nullptr;
+        }
+
         for(auto s = sections; s->name != nullptr; ++s)
         {
             if(s->name[0])
@@ -45,6 +85,20 @@ struct section_info
     // This version looks only for the first 'n' characters from the line, or if -1 based on the strlen of the section name
     static const section_info* by_name(const section_info* sections, const char* line, size_t line_strlen, int n)
     {
+        if(sections->index && n != 0)
+        {
+            // Any section that matches at least one character must start with the same character as the line
+            if(line_strlen == 0) return nullptr;
+            for(int i = sections->index->head[(unsigned char)(line[0])]; i != -1; i = sections[i].next)
+            {
+                auto s = &sections[i];
+                size_t len = (n == -1? s->len : n);
+                if(line_strlen >= len && !strncmp(line, s->name, len))
+                    return s;
+            }
+            return nullptr;
+        }
+
         for(auto s = sections; s->name != nullptr; ++s)
         {
             if(s->name[0])
@@ -58,14 +112,34 @@ struct section_info
     }
 
     // Finds the a section_info object in the 'sections' array based on the specified name.
-    static const section_info* by_name(const section_info* sections, const std::string& line)
+    // This version compares against the whole 'line', which doesn't need to be null terminated
+    static const section_info* by_name(const section_info* sections, boost::string_ref line)
     {
-        return by_name(sections, line.data());
+        if(sections->index)
+        {
+            if(line.empty()) return nullptr;
+            for(int i = sections->index->head[(unsigned char)(line[0])]; i != -1; i = sections[i].next)
+            {
+                if(line == sections[i].name)
+                    return &sections[i];
+            }
+            return nullptr;
+        }
+
+        for(auto s = sections; s->name != nullptr; ++s)
+        {
+            if(s->name[0])
+            {
+                if(line == s->name)
+                    return s;
+            }
+        }
+        return nullptr;
     }
 
     // Finds the a section_info object in the 'sections' array based on the specified name.
     // This version looks only for the first 'n' characters from the line, or if -1 based on the strlen of the section name
-    static const section_info* by_name(const section_info* sections, const std::string& line, int n)
+    static const section_info* by_name(const section_info* sections, boost::string_ref line, int n)
     {
         return by_name(sections, line.data(), line.length(), n);
     }
@@ -73,17 +147,40 @@ struct section_info
 
 };
 
+static_assert(std::is_trivially_copyable<section_info>::value, "section_info must be trivially copyable");
+
 template<class... Args>
 using section_array = std::array<section_info, sizeof...(Args) + 1>;
 
 // Builds a array of section info objects, putting a null terminator and setting up the indices correctly
+// The lookup table used by section_info::by_name is built here as well
 // NOTE SECTIONS MUST BE SENT IN THE SAME ORDER AS DATA DECLARED IN gta3::data_section !!!!!!!!!!!!!!!!!!!!!!!
 template<class... Args> inline
 static section_array<Args...> make_section_info(Args&&... a)
 {
+    static_assert(sizeof...(Args) < 0x7FFF, "too many sections");
+
     auto array = section_array<Args...>( { a..., (const char*)(nullptr) } );
     for(int i = 0; i < (int(array.size()) - 1); ++i)    // last element should have a -1 id, others it's respective index
         array[i].id = i;
+
+    // Chains the sections by their first character, in the array order (sections with empty names are never matched)
+    // The table is kept once for the array (not in each section_info), it lives as long as the program
+    section_index index;
+    std::fill(std::begin(index.head), std::end(index.head), short(-1));
+    for(int i = (int(array.size()) - 2); i >= 0; --i)
+    {
+        if(array[i].name[0])
+        {
+            auto& head = index.head[(unsigned char)(array[i].name[0])];
+            array[i].next = head;
+            head = short(i);
+        }
+    }
+
+    auto kept = section_index::keep(index);
+    for(auto& s : array)
+        s.index = kept;
     return array;
 }
 
@@ -158,6 +255,12 @@ class data_section
             return false;
         }
 
+        // Hashes the content of this object consistently with 'operator=='
+        std::size_t hash() const
+        {
+            return this->has_section()? hash_data(this->data) : 0;
+        }
+
         bool operator<(const data_section& rhs) const
         {
             if(this->has_section() && rhs.has_section())
@@ -183,7 +286,7 @@ class data_section
 
         // Checks if the data present in line is compatible with the section specifier and sets the working section for this object.
         // In case the line doesn't match the section specifier, the working section gets invalidated and the method returns false
-        bool as_section(const section_info* tsection, const std::string& line)
+        bool as_section(const section_info* tsection, boost::string_ref line)
         {
             if(tsection) assert(tsection->id < num_sections);
             as_section_fn fn(*this, tsection);
@@ -192,6 +295,19 @@ class data_section
             return has_section();
         }
 
+        // Sets the working section to 'tsection' and the content of this data storer to be what's on the line (by interpreting it)
+        // This is the same as 'as_section(tsection, line) && set(line)' but the line is scanned only once.
+        // In case the line doesn't match the section specifier, the working section gets invalidated and the method returns false
+        bool set(const section_info* tsection, boost::string_ref line)
+        {
+            if(tsection == nullptr)
+                return false;
+
+            this->force_section(tsection);
+            if(!this->set(line)) this->tsection = nullptr;
+            return has_section();
+        }
+
         // Forces the current section specifier to be 'tsection'
         // Be very careful when using this function
         void force_section(const section_info* tsection)
@@ -217,24 +333,24 @@ class data_section
 
         // Cheaply checks whether the content of 'line' can be stored in this data storer depending on the working section
         // If this return true, mostly like 'this->set(line)' will also return true
-        bool check(const std::string& line) const
+        bool check(boost::string_ref line) const
         {
             check_visitor visitor(line);
-            return ::apply_visitor(visitor, this->data);
+            return datalib::apply_visitor(visitor, this->data);
         }
 
         // Sets the content of this data storer to be what's on the line (by interpreting it)
-        bool set(const std::string& line)
+        bool set(boost::string_ref line)
         {
             set_visitor visitor(line);
-            return ::apply_visitor(visitor, this->data);
+            return datalib::apply_visitor(visitor, this->data);
         }
 
         // Gets the content of this data storer into the line (by disassembling it)
         bool get(std::string& line)  const
         {
             get_visitor visitor(line);
-            return ::apply_visitor(visitor, const_cast<either_type&>(this->data));
+            return datalib::apply_visitor(visitor, const_cast<either_type&>(this->data));
         }
 
         // Gets the nth element 'I' of type 'Type' from the working section data_slice
@@ -266,7 +382,7 @@ class data_section
 
         // CXX14 HELP-ME
         template<class Visitor>
-        auto apply_visitor(Visitor& visitor) const -> decltype(datalib::apply_visitor(std::declval<Visitor>(), std::declval<either_type>()))
+        auto apply_visitor(Visitor& visitor) const -> decltype(datalib::apply_visitor(std::declval<Visitor&>(), std::declval<either_type&>()))
         {
             return datalib::apply_visitor(visitor, const_cast<either_type&>(this->data));
         }
@@ -320,8 +436,8 @@ class data_section
 
         struct check_visitor : either_static_visitor<bool>
         {
-            const std::string& line;
-            check_visitor(const std::string& line) : line(line) {}
+            boost::string_ref line;
+            check_visitor(boost::string_ref line) : line(line) {}
 
             template<class T>
             bool operator()(const T& value) const
@@ -337,8 +453,8 @@ class data_section
 
         struct set_visitor : either_static_visitor<bool>
         {
-            const std::string& line;
-            set_visitor(const std::string& line) : line(line) {}
+            boost::string_ref line;
+            set_visitor(boost::string_ref line) : line(line) {}
 
             template<class T>
             bool operator()(T& value) const
@@ -375,7 +491,7 @@ class data_section
             template<class T>
             Type& operator()(T& slice) const
             {
-                return ::get<I>(slice);
+                return datalib::get<I>(slice);
             }
 
             Type& operator()(either_blank) const
@@ -388,14 +504,14 @@ class data_section
         struct get_nth_visitor_p : either_static_visitor<Type*>
         {
             template<class T>
-            typename std::enable_if<std::is_same<Type, std::decay_t<decltype(::get<I>(std::declval<T&>()))>>::value, Type*>::type
+            typename std::enable_if<std::is_same<Type, std::decay_t<decltype(datalib::get<I>(std::declval<T&>()))>>::value, Type*>::type
             /* Type* */ operator()(T& slice) const 
             {
-                return &(::get<I>(slice));
+                return &(datalib::get<I>(slice));
             }
 
             template<class T>
-            typename std::enable_if<!std::is_same<Type, std::decay_t<decltype(::get<I>(std::declval<T&>()))>>::value, Type*>::type
+            typename std::enable_if<!std::is_same<Type, std::decay_t<decltype(datalib::get<I>(std::declval<T&>()))>>::value, Type*>::type
             /* Type* */ operator()(T& slice) const 
             {
                 return nullptr;
@@ -447,11 +563,27 @@ using data_section_visitor = either_static_visitor<T>;
 template<typename ...Sections> inline
 const section_info* sections(const data_section<Sections...>& ds)
 {
-    static_assert(false, "sections(...) not implemented for this data_section type");
+    static_assert(sizeof...(Sections) != sizeof...(Sections), "sections(...) not implemented for this data_section type");
+    return nullptr;
 }
 
 
 
 } // namespace gta3
+
+
+/*
+ *  data_hash<> specialization for 'gta3::data_section<Sections...>'
+ */
+template<typename ...Sections>
+struct data_hash<gta3::data_section<Sections...>>
+{
+    std::size_t operator()(const gta3::data_section<Sections...>& data) const
+    {
+        return data.hash();
+    }
+};
+
+
 } // namespace datalib
 
@@ -54,6 +54,9 @@ namespace gta3 {
  *                                                 Notice this should check and set the state of the MainData object.
  *                                                 Return false on failure.
  *
+ *                                                 The line String given to those is a boost::string_ref, usually into the
+ *                                                 file buffer itself, so it isn't null terminated.
+ *
  *              bool posread(Store)             -> After successfully reading the contents from a file into the specified store,
  *                                                 this traits method gets called, you can take a chance to post-process the readen data.
  *
@@ -93,6 +96,11 @@ class data_store final : public datalib::data_store<ContainerType>
         using base = datalib::data_store<ContainerType>;
 
     public:
+        using key_type       = typename base::key_type;
+        using mapped_type    = typename base::mapped_type;
+        using pair_type      = typename base::pair_type;
+        using allocator_type = typename base::allocator_type;
+
 
         //
         //  Constructors
@@ -100,6 +108,9 @@ class data_store final : public datalib::data_store<ContainerType>
 
         data_store() = default;
 
+        explicit data_store(const typename base::allocator_type& alloc) :
+            base(alloc) {}
+
         data_store(const data_store& rhs) :
             base(rhs), mtraits(rhs.mtraits) {}
 
@@ -142,13 +153,13 @@ class data_store final : public datalib::data_store<ContainerType>
         // find a better name for this method
         template<class traits_type = TraitsType>
         typename std::enable_if<!traits_type::is_reversed_kv, bool>::type
-        /* bool */ insert(const section_info* section, const std::string& line)
+        /* bool */ insert(const section_info* section, boost::string_ref line)
         {
             mapped_type value;
             if(traits_type::setbyline(*this, value, section, line))
             {
                 key_type key = mtraits.key_from_value(value);
-                map.emplace(std::move(key), std::move(value));
+                this->map.emplace(std::move(key), std::move(value));
                 return true;
             }
             return false;
@@ -157,13 +168,13 @@ class data_store final : public datalib::data_store<ContainerType>
         // find a better name for this method
         template<class traits_type = TraitsType>
         typename std::enable_if<traits_type::is_reversed_kv, bool>::type
-        /* bool */ insert(const section_info* section, const std::string& line)
+        /* bool */ insert(const section_info* section, boost::string_ref line)
         {
             key_type key;
             if(traits_type::setbyline(*this, key, section, line))
             {
                 mapped_type value = mtraits.value_from_key(key);
-                map.emplace(std::move(key), std::move(value));
+                this->map.emplace(std::move(key), std::move(value));
                 return true;
             }
             return false;
@@ -171,16 +182,16 @@ class data_store final : public datalib::data_store<ContainerType>
 
         template<class Section, class traits_type = TraitsType>
         typename std::enable_if<traits_type::has_sections && !traits_type::is_reversed_kv, bool>::type
-        /* bool */ insert(const std::string& line)
+        /* bool */ insert(boost::string_ref line)
         {
-            return this->insert(mapped_type::section_by_slice<Section>(), line);
+            return this->insert(mapped_type::template section_by_slice<Section>(), line);
         }
 
         template<class Section, class traits_type = TraitsType>
         typename std::enable_if<traits_type::has_sections && traits_type::is_reversed_kv, bool>::type
-        /* bool */ insert(const std::string& line)
+        /* bool */ insert(boost::string_ref line)
         {
-            return this->insert(key_type::section_by_slice<Section>(), line);
+            return this->insert(key_type::template section_by_slice<Section>(), line);
         }
 
         // Merges the specified data_store into this data_store, replacing any existing element from 
@@ -224,7 +235,7 @@ class data_store final : public datalib::data_store<ContainerType>
          */
         static bool getline(const key_type& key, const mapped_type& value, std::string& line)
         {
-            return traits_type::getline<data_store>(key, value, line);
+            return traits_type::template getline<data_store>(key, value, line);
         }
 
         /*
@@ -257,7 +268,7 @@ class data_store final : public datalib::data_store<ContainerType>
          */
 
         // Finds the section object from the current line
-        static const section_info* section_by_line(const section_info* sections, const std::string& line)
+        static const section_info* section_by_line(const section_info* sections, boost::string_ref line)
         {
             return traits_type::section_by_line(sections, line);
         }
@@ -272,7 +283,7 @@ class data_store final : public datalib::data_store<ContainerType>
         template<class MergedList, class FuncDoWrite>
         static bool prewrite(MergedList merged, FuncDoWrite dowrite)
         {
-            return traits_type::prewrite<data_store>(std::move(merged), std::move(dowrite));
+            return traits_type::template prewrite<data_store>(std::move(merged), std::move(dowrite));
         }
 
         // Called just before the merging process (comparisions and all that)
@@ -334,15 +345,15 @@ struct data_traits
 
     template<class StoreType, typename TData>
     typename std::enable_if<StoreType::traits_type::has_sections, bool>::type
-    static /* bool */ setbyline(StoreType& store, TData& data, const section_info* section, const std::string& line)
+    static /* bool */ setbyline(StoreType& store, TData& data, const section_info* section, boost::string_ref line)
     {
-        return (data.as_section(section, line) && data.set(line));
+        return data.set(section, line);
     }
     template<class StoreType, typename TData>
     typename std::enable_if<!StoreType::traits_type::has_sections, bool>::type
-    static /* bool */ setbyline(StoreType& store, TData& data, const section_info* section, const std::string& line)
+    static /* bool */ setbyline(StoreType& store, TData& data, const section_info* section, boost::string_ref line)
     {
-        return (data.check(line) && data.set(line));
+        return data.set(line);
     }
 
 
@@ -359,7 +370,7 @@ struct data_traits
         return key.get(line);
     }
 
-    static const section_info* section_by_line(const section_info* sections, const std::string& line)
+    static const section_info* section_by_line(const section_info* sections, boost::string_ref line)
     {
         return section_info::by_name(sections, line);
     }
@@ -9,7 +9,13 @@
 #include <fstream>
 #include <string>
 #include <functional>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
 #include <datalib/gta3/data_section.hpp>
+#include <datalib/detail/mapped_file.hpp>
+#include <datalib/detail/file_writer.hpp>
+#include <datalib/dominance.hpp>
 
 namespace datalib {
 namespace gta3 {
@@ -22,48 +28,59 @@ namespace gta3 {
 
 
 /*
- *  trim_config_line
- *      Trims a config line just like gta3 does internally
- *      Essentially removes all comments (';', '#"), replaces ',' and space characters with ' ' and trims left and right.
+ *  trim_config_span
+ *      Trims the config line in the character range [begin, end) in place, just like gta3 does internally.
+ *      Returns the trimmed range, which is a subrange of [begin, end).
+ *      See trim_config_line for details.
  */
-inline std::string& trim_config_line(std::string& line, bool remove_separators = true)
+inline std::pair<char*, char*> trim_config_span(char* begin, char* end, bool remove_separators = true)
 {
-    bool trim_front = true;
-    std::size_t trim_back = line.npos;
+    char* first = nullptr;      // first non-whitespace char
+    char* last  = nullptr;      // first char of the trailing whitespaces
+    char* p     = begin;
 
-    for(std::size_t pos = 0; pos < line.length(); ++pos)
+    for(; p != end; ++p)
     {
-        unsigned char c = line[pos];    // (uchar for unsigned less than)
+        unsigned char c = *p;    // (uchar for unsigned less than)
         if(c <= ' ' || c == ',')
         {
             if(c != ',' || remove_separators)
             {
-                if(trim_back == line.npos) trim_back = pos;
-                line[pos] = ' ';
+                if(last == nullptr) last = p;
+                *p = ' ';
             }
         }
         else if(c == '#' || c == ';')
         {
-            if(trim_back == line.npos) trim_back = pos;
-            line.erase(pos);
+            if(last == nullptr) last = p;
             break;
         }
         else
         {
-            trim_back = line.npos;
-            if(trim_front)
-            {
-                // first non-whitespace char
-                trim_front = false;
-                line.erase(0, pos);
-                pos = 0;
-            }
+            last = nullptr;
+            if(first == nullptr) first = p;
         }
     }
 
-    if(trim_back != line.npos)
-        line.erase(trim_back);
+    if(last == nullptr) last = p;
+    if(first == nullptr) first = begin;
+    return std::make_pair(first, last);
+}
 
+/*
+ *  trim_config_line
+ *      Trims a config line just like gta3 does internally
+ *      Essentially removes all comments (';', '#"), replaces ',' and space characters with ' ' and trims left and right.
+ */
+inline std::string& trim_config_line(std::string& line, bool remove_separators = true)
+{
+    if(line.size())
+    {
+        char* data = &line[0];
+        auto span  = trim_config_span(data, data + line.size(), remove_separators);
+        line.erase(span.second - data);
+        line.erase(0, span.first - data);
+    }
     return line;
 }
 
@@ -96,6 +113,103 @@ inline bool getline(std::pair<ForwardIterator, ForwardIterator>& in, std::string
     return false;
 }
 
+/*
+ *  find_config_eol
+ *      Finds the end of the line ('\n' or '\0') in the character range [begin, end), returns end if there's none.
+ *      The range is scanned a machine word at a time, only the word containing the line ending is looked byte by byte.
+ */
+inline const char* find_config_eol(const char* begin, const char* end)
+{
+    typedef std::size_t word_type;
+    static const word_type ones  = word_type(-1) / 0xFF;   // 0x0101...
+    static const word_type highs = ones * 0x80;            // 0x8080...
+    static const word_type lfs   = ones * '\n';            // 0x0A0A...
+
+    const char* p = begin;
+
+    // Walk byte by byte until the pointer gets word aligned
+    for(; p != end && (reinterpret_cast<std::uintptr_t>(p) % sizeof(word_type)); ++p)
+    {
+        if(*p == '\n' || *p == 0) return p;
+    }
+
+    // Walk word by word until one of the bytes in the word is either zero or a line feed
+    for(; std::size_t(end - p) >= sizeof(word_type); p += sizeof(word_type))
+    {
+        word_type w; std::memcpy(&w, p, sizeof(w));
+        word_type x = w ^ lfs;
+        if((((w - ones) & ~w) | ((x - ones) & ~x)) & highs)
+            break;
+    }
+
+    // Find the exact position of the line ending (if any)
+    for(; p != end; ++p)
+    {
+        if(*p == '\n' || *p == 0) return p;
+    }
+    return end;
+}
+
+/*
+ *  config_line_iterator
+ *      Input iterator over the non-empty trimmed lines (see trim_config_line) of a whole mutable character buffer.
+ *      The lines are trimmed in place and exposed as [begin, end) spans, no line is copied or allocated.
+ *      A default constructed iterator is the end iterator.
+ */
+class config_line_iterator : public std::iterator<std::input_iterator_tag, std::pair<char*, char*>>
+{
+    public:
+        using span_type = std::pair<char*, char*>;
+
+        config_line_iterator() :
+            cur(nullptr), end(nullptr), line(nullptr, nullptr)
+        {}
+
+        config_line_iterator(char* begin, char* end) :
+            cur(begin), end(end), line(nullptr, nullptr)
+        {
+            this->next();
+        }
+
+        const span_type& operator*() const  { return this->line; }
+        const span_type* operator->() const { return &this->line; }
+
+        config_line_iterator& operator++()
+        {
+            this->next();
+            return *this;
+        }
+
+        config_line_iterator operator++(int)
+        {
+            auto copy = *this;
+            this->next();
+            return copy;
+        }
+
+        bool operator==(const config_line_iterator& rhs) const { return this->line.first == rhs.line.first; }
+        bool operator!=(const config_line_iterator& rhs) const { return this->line.first != rhs.line.first; }
+
+    private:
+        char* cur;
+        char* end;
+        span_type line;
+
+        // Moves to the next non-empty line, or becomes the end iterator if there's none
+        void next()
+        {
+            while(cur != end)
+            {
+                char* eol = const_cast<char*>(find_config_eol(cur, end));
+                this->line = trim_config_span(cur, eol);
+                this->cur  = (eol != end? eol + 1 : end);
+                if(line.first != line.second)
+                    return;
+            }
+            this->line = span_type(nullptr, nullptr);
+        }
+};
+
 
 
 
@@ -103,6 +217,7 @@ inline bool getline(std::pair<ForwardIterator, ForwardIterator>& in, std::string
  *  parse_from_stream
  *      Functor which parses the content of an stream and inserts it into a store.
  *      Also accepts a pair of iterators as parameter instead of a stream.
+ *      A pair of mutable char pointers is parsed in place by a config_line_iterator (the buffer content gets trimmed).
  */
 struct parse_from_stream
 {
@@ -120,9 +235,15 @@ struct parse_from_stream
             return this->read(store, bufpair);
         }
 
-    private:
+        template<class StoreType>
+        bool operator()(StoreType& store, std::pair<char*, char*>& bufpair) const
+        {
+            auto lines = std::make_pair(config_line_iterator(bufpair.first, bufpair.second), config_line_iterator());
+            bufpair.first = bufpair.second;
+            return this->read(store, lines);
+        }
 
-        static const std::size_t line_reserve = 512;
+    private:
 
         template<class StoreType, class StreamType>
         bool read(StoreType& store, StreamType& stream) const
@@ -147,38 +268,65 @@ struct parse_from_stream
         }
 
 
+        // Fetches the next non-empty trimmed line from a stream or a pair of iterators
+        // The line is read into 'buffer' and 'line' refers to it
+        template<class StreamType>
+        static bool next_line(StreamType& stream, std::string& buffer, boost::string_ref& line)
+        {
+            while(getline(stream, buffer))
+            {
+                if(trim_config_line(buffer).size())
+                {
+                    line = buffer;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Fetches the next line from a pair of config_line_iterator, those lines are already trimmed and non-empty
+        // The line refers to the buffer being iterated, nothing is copied into 'buffer'
+        static bool next_line(std::pair<config_line_iterator, config_line_iterator>& lines, std::string& buffer, boost::string_ref& line)
+        {
+            if(lines.first != lines.second)
+            {
+                line = boost::string_ref(lines.first->first, lines.first->second - lines.first->first);
+                ++lines.first;
+                return true;
+            }
+            return false;
+        }
+
         template<class StoreType, class StreamType>
         bool read_withsec(StoreType& store, StreamType& stream) const
         {
-            std::string line; line.reserve(line_reserve);
+            std::string buffer;
+            boost::string_ref line;
             const section_info* sections = store.sections();
             bool per_line_section = store.per_line_section;
 
             const section_info* section = nullptr;
 
-            while(getline(stream, line))
+            while(next_line(stream, buffer, line))
             {
-                if(trim_config_line(line).size())
+                // take care of sectioning
+                if(section == nullptr || per_line_section)
                 {
-                    // take care of sectioning
-                    if(section == nullptr || per_line_section)
-                    {
-                        section = store.section_by_line(sections, line);
-                        if(!per_line_section) continue;
-                    }
-                    else if(!strcmp(line.data(), "end"))
-                    {
-                        section = nullptr;
-                        continue;
-                    }
+                    section = store.section_by_line(sections, line);
+                    if(!per_line_section) continue;
+                }
+                else if(line == "end")
+                {
+                    section = nullptr;
+                    continue;
+                }
 
-                    // read the line as the specified section
-                    if(section != nullptr)
+                // read the line as the specified section
+                if(section != nullptr)
+                {
+                    if(!store.insert(section, line))
                     {
-                        if(!store.insert(section, line))
-                        {
-                            // tolerant to this kind of failure
-                        }
+                        // tolerant to this kind of failure
                     }
                 }
             }
@@ -188,16 +336,14 @@ struct parse_from_stream
         template<class StoreType, class StreamType>
         bool read_woutsec(StoreType& store, StreamType& stream) const
         {
-            std::string line; line.reserve(line_reserve);
+            std::string buffer;
+            boost::string_ref line;
 
-            while(getline(stream, line))
+            while(next_line(stream, buffer, line))
             {
-                if(trim_config_line(line).size())
+                if((store.insert(nullptr, line)) == false)
                 {
-                    if((store.insert(nullptr, line)) == false)
-                    {
-                        // tolerant to this kind of failure
-                    }
+                    // tolerant to this kind of failure
                 }
             }
 
@@ -209,35 +355,18 @@ struct parse_from_stream
 /*
  *  parse_from_file
  *      Functor which parses the content of an file name and inserts it into a store.
+ *      The file is mapped into memory (see mapped_file) and parsed in place, whatever its size is.
  */
 struct parse_from_file
 {
-    // If the file has the size greater than this, it'll parse using a stream otherwise reading it completly into memory and then parsing there.
-    static const std::streamoff max_size_for_memory = 2097152;  // 2MiB
-
     template<class StoreType>
     bool operator()(StoreType& store, const char* filename) const
     {
-        std::ifstream stream(filename, std::ios::binary);   // open as binary even if we are working with text
-                                                            // first because well need to determine the file size
-                                                            // and why to reopen it if getline works here and we gonna trim line endings?
-        if(stream)
+        mapped_file file(filename);
+        if(file.is_open())
         {
-            std::streamoff filesize;
-            if(stream.seekg(0, std::ios::end) && ((filesize = stream.tellg()) != std::streamoff(-1)))
-            {
-                if(filesize <= max_size_for_memory)
-                {
-                    auto ufilesize = (size_t)filesize;
-                    std::unique_ptr<char[]> buffer(new char[ufilesize]);
-                    if(stream.seekg(0, std::ios::beg) && stream.read(&buffer[0], filesize))
-                        return parse_from_stream()(store, std::make_pair(&buffer[0], &buffer[ufilesize]));
-                }
-            }
-
-            // reading into memory buffer didn't happen, then read line by line
-            if(stream.seekg(0, std::ios::beg))
-                return parse_from_stream()(store, stream);
+            auto bufpair = std::make_pair(file.begin(), file.end());
+            return parse_from_stream()(store, bufpair);
         }
         return false;
     }
@@ -263,17 +392,18 @@ struct store_merger
 
         // Merges the data stores in the iterator [st_begin, st_end] and outputs the result into the file 'outfilename'
         // Notice 'domflags' is a functor which returns the dominance flag based on the key sent to it
+        // The output file is only replaced when the whole merge succeeds
         template<class StoreType, class ForwardIterator, class DomFlags>
         bool operator()(const char* outfilename, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
         {
-            std::ofstream stream(outfilename);
+            buffered_file_writer stream(outfilename);
             if(stream)
             {
                 std::for_each(st_begin, st_end, [](StoreType& store) { store.premerge(); });
                 auto result = do_merge<StoreType>(stream, st_begin, st_end, domflags);
                 std::for_each(st_begin, st_end, [](StoreType& store) { store.posmerge(); });
                 write_eof<StoreType>(stream);
-                return result;
+                return result && stream.commit();
             }
             return false;
         }
@@ -282,11 +412,6 @@ struct store_merger
 
         static const std::size_t line_reserve = 512;
 
-        template<class Key>
-        using keylist_sorted_type = std::set<std::reference_wrapper<const Key>, std::less<Key>> ;
-        template<class Key>
-        using keylist_ordered_type = std::vector<std::reference_wrapper<const Key>> ;
-
         // Write helper to select between write_withsec/write_woutsec using the integral_constant boolean as the first parameter
         template<class StoreType, class ForwardIterator, class StreamType>
         bool write(std::true_type has_section, ForwardIterator begin, ForwardIterator end, StreamType& stream) const
@@ -353,29 +478,6 @@ struct store_merger
 
 
 
-        // Pushes the key to the container if there's none equal to it yet
-        template<class Key>
-        bool push_unique(keylist_sorted_type<Key>& list, const Key& key)
-        {
-            // fine, this is a std::set, defaults to unique anyway
-            return list.emplace(std::cref(key)).second;
-        }
-
-        // Pushes the key to the container if there's none equal to it yet
-        template<class Key>
-        bool push_unique(keylist_ordered_type<Key>& list, const Key& key)
-        {
-            if(std::find_if(list.begin(), list.end(), [&key](const Key& a)
-            {
-                return (a == key);
-            }) == list.end())
-            {
-                list.emplace_back(std::cref(key));
-                return true;
-            }
-            return false;
-        }
-
         template<class ForwardIterator>
         using merge_result = std::vector<std::pair<
                                 std::reference_wrapper<std::add_const_t<typename std::iterator_traits<ForwardIterator>::value_type::key_type>>,
@@ -387,42 +489,15 @@ struct store_merger
         auto merge(ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags) ->
                 merge_result<ForwardIterator>
         {
-            // Aliases
-            using store_type = std::iterator_traits<ForwardIterator>::value_type;
+            using store_type = typename std::iterator_traits<ForwardIterator>::value_type;
             using key_type = typename store_type::key_type;
             using mapped_type = typename store_type::mapped_type;
 
-            //using relist_type = std::vector < std::pair <
-            //    std::reference_wrapper<const key_type>, std::reference_wrapper < mapped_type >
-            //    >> ;
-            using relist_type = merge_result<ForwardIterator>;
-
-            using keylist_type =
-                std::conditional < store_type::is_sorted,
-                keylist_sorted_type<key_type>,
-                keylist_ordered_type<key_type>
-                > ::type;
-
-            // Actual code is here lol
-
-            keylist_type keys;
-            relist_type  output;
-
-            for(auto st = st_begin; st != st_end; ++st)
+            merge_result<ForwardIterator> output;
+            merge_dominant_data(st_begin, st_end, domflags, [&output](const key_type& key, mapped_type& value)
             {
-                if(st->ready())
-                {
-                    for(auto& kv : st->container())
-                        push_unique(keys, kv.first);
-                }
-            }
-
-            for(auto& key : keys)
-            {
-                if(auto* vdom = find_dominant_data(st_begin, st_end, key.get(), domflags(key.get())))
-                    output.emplace_back(key, *vdom);
-            }
-
+                output.emplace_back(std::cref(key), std::ref(value));
+            });
             return output;
         }
 
@@ -431,7 +506,7 @@ struct store_merger
         template<class StoreType>
         struct fn_dowrite
         {
-            fn_dowrite(store_merger& merger, std::ofstream& stream) :
+            fn_dowrite(store_merger& merger, buffered_file_writer& stream) :
                 merger(merger), stream(stream)
             {}
 
@@ -445,24 +520,24 @@ struct store_merger
 
             private:
             store_merger& merger;
-            std::ofstream& stream;
+            buffered_file_writer& stream;
         };
 
         template<class StoreType, class ForwardIterator, class DomFlags>
-        bool do_merge(std::false_type, std::ofstream& stream, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
+        bool do_merge(std::false_type, buffered_file_writer& stream, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
         {
             return StoreType::prewrite(merge(st_begin, st_end, domflags), fn_dowrite<StoreType>(*this, stream));
         }
 
         template<class StoreType, class ForwardIterator, class DomFlags>
-        bool do_merge(std::true_type, std::ofstream& stream, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
+        bool do_merge(std::true_type, buffered_file_writer& stream, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
         {
-            auto xc = StoreType::traits_type::process_stlist<StoreType>(st_begin, st_end);
+            auto xc = StoreType::traits_type::template process_stlist<StoreType>(st_begin, st_end);
             return StoreType::prewrite(merge(xc.begin(), xc.end(), domflags), fn_dowrite<StoreType>(*this, stream));
         }
 
         template<class StoreType, class ForwardIterator, class DomFlags>
-        bool do_merge(std::ofstream& stream, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
+        bool do_merge(buffered_file_writer& stream, ForwardIterator st_begin, ForwardIterator st_end, DomFlags domflags)
         {
             return do_merge<StoreType>(std::integral_constant<bool, StoreType::traits_type::do_stlist>(),
                                               stream, st_begin, st_end, domflags);
@@ -470,20 +545,20 @@ struct store_merger
 
 
         template<class StoreType>
-        bool write_eof(std::false_type, std::ofstream& stream) const
+        bool write_eof(std::false_type, buffered_file_writer& stream) const
         {
             return true;
         }
 
         template<class StoreType>
-        bool write_eof(std::true_type, std::ofstream& stream) const
+        bool write_eof(std::true_type, buffered_file_writer& stream) const
         {
             stream << StoreType::traits_type::eof_string() << '\n';
             return true;
         }
 
         template<class StoreType>
-        bool write_eof(std::ofstream& stream) const
+        bool write_eof(buffered_file_writer& stream) const
         {
             return write_eof<StoreType>(std::integral_constant<bool, StoreType::traits_type::has_eof_string>(), stream);
         }
@@ -7,17 +7,23 @@
 #include <array>
 #include <datalib/data_info/array.hpp>
 #include <datalib/detail/stream/fwd.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 
 namespace datalib {
 
+template<class T, std::size_t N>
+struct min_tokens<std::array<T, N>> :
+    std::integral_constant<std::size_t, N * min_tokens<T>::value>
+{};
+
 /*
  *  Input Checker
  */
 template<class CharT, class Traits, class T, std::size_t N> inline
 datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstream<CharT, Traits>& is, const std::array<T, N>& array)
 {
-    datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is, true);
-    datalib::basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
+    typename datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is, true);
+    typename datalib::basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
     if(xsentry)
     {
         for(std::size_t i = 0; i < N; ++i)
@@ -26,17 +32,13 @@ datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstre
     return is;
 }
 
-}
-
-namespace std {
-
 /*
  *  Input
  */
 template<class CharT, class Traits, class T, std::size_t N> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, std::array<T, N>& array)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, std::array<T, N>& array)
 {
-    std::basic_istream<CharT, Traits>::sentry xsentry(is);
+    typename datalib::basic_imemstream<CharT, Traits>::sentry xsentry(is);
     if(xsentry)
     {
         for(std::size_t i = 0; i < N; ++i)
@@ -45,20 +47,24 @@ std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>&
     return is;
 }
 
+}
+
+namespace std {
+
 /*
  *  Output
  */
 template<class CharT, class Traits, class T, std::size_t N> inline
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const std::array<T, N>& array)
 {
-    std::basic_ostream<CharT, Traits>::sentry xsentry(os);
+    typename std::basic_ostream<CharT, Traits>::sentry xsentry(os);
     if(xsentry)
     {
         for(std::size_t i = 0; i < N; ++i)
         {
             if(os << array[i])
             {
-                if(print_separator<T>(os).fail())
+                if(datalib::print_separator<T>(os).fail())
                     break;
             }
             else break;
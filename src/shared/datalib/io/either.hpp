@@ -7,6 +7,7 @@
 #include <datalib/data_info/either.hpp>
 #include <datalib/detail/stream/fwd.hpp>
 #include <datalib/detail/stream/kstream.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 #include <datalib/detail/mpl/seqeach.hpp>
 
 namespace datalib {
@@ -95,6 +96,10 @@ namespace detail
             // we won't take the time to construct a proper object
             auto& dummy_ref = *((const typename TypeWr::type*)(nullptr));
 
+            // Not enough tokens left for this type, don't even try it
+            if(min_tokens<typename TypeWr::type>::value > is.remaining_tokens())
+                return true;
+
             // Check if it's possible to take the text on the stream pointer to the specified type
             if(is >> dummy_ref)
             {
@@ -121,9 +126,30 @@ namespace detail
         }
 
     };
+
+    // Finds the minimum of min_tokens<> between 'Types...'
+    template<class... Types>
+    struct either_min_tokens;
+
+    template<class T>
+    struct either_min_tokens<T> : min_tokens<T>
+    {};
+
+    template<class T, class... Types>
+    struct either_min_tokens<T, Types...> :
+        std::integral_constant<std::size_t, (min_tokens<T>::value < either_min_tokens<Types...>::value?
+                                                min_tokens<T>::value : either_min_tokens<Types...>::value)>
+    {};
 }
 
 
+/*
+ *  min_tokens<> specialization for 'either<Types...>'
+ *  An either object consumes as little as its smallest alternative
+ */
+template<class... Types>
+struct min_tokens<either<Types...>> : detail::either_min_tokens<Types...>
+{};
 
 
 /*
@@ -137,7 +163,7 @@ basic_icheckstream<CharT, Traits>& operator>>(basic_icheckstream<CharT, Traits>&
     {
         // Find index to associate the input to the either object
         int result = -1;
-        detail::lambda_either_find_index<std::decay<decltype(either)>::type> fun(is, either, result);
+        detail::lambda_either_find_index<typename std::decay<decltype(either)>::type> fun(is, either, result);
         foreach_type_variadic<Args...>()(fun);
 
         // If no index could be associated with the input, it indicates failure
@@ -153,23 +179,23 @@ basic_icheckstream<CharT, Traits>& operator>>(basic_icheckstream<CharT, Traits>&
 template<class CharT, class Traits, class ...Args> inline
 basic_imemstream<CharT, Traits>& operator>>(basic_imemstream<CharT, Traits>& is, either<Args...>& either)
 {
-    basic_imemstream<CharT, Traits>::sentry xsentry(is);
+    typename basic_imemstream<CharT, Traits>::sentry xsentry(is);
     if(xsentry)
     {
         int type_index = -1;
 
-        // Make a stream checker with the current stream position (because we need to know the type we need to read in the first place)
-        auto tell = std::streamoff(is.rdbuf()->pubseekoff(0, std::ios::cur, std::ios::in));
-        basic_icheckstream<CharT, Traits>  icheck((char*)(is.rdbuf()->buffer()) + tell, size_t(is.rdbuf()->size() - tell));
+        // Take a stream checker at the current stream position (because we need to know the type we need to read in the first place)
+        // The checker shares the tokens of the stream, so the alternatives do not classify the same tokens again
+        basic_icheckstream<CharT, Traits>& icheck = is.checker();
         // Find the index of the type we need to read (this index isn't the which()!)
-        detail::lambda_either_find_index<std::decay<decltype(either)>::type> index_fun(icheck, either, type_index);
+        detail::lambda_either_find_index<typename std::decay<decltype(either)>::type> index_fun(icheck, either, type_index);
         foreach_type_variadic<Args...>()(index_fun);
 
         if(type_index != -1)
         {
             // Read from the stream the specified type into the either object
             bool reading_result = false;
-            detail::lambda_either_read_val<std::decay<decltype(either)>::type> xreader_fun(is, either, type_index, reading_result);
+            detail::lambda_either_read_val<typename std::decay<decltype(either)>::type> xreader_fun(is, either, type_index, reading_result);
             foreach_type_variadic<Args...>()(xreader_fun);
             if(!reading_result) is.setstate(std::ios::failbit); // :(
         }
@@ -8,12 +8,12 @@
 #include <type_traits>
 #include <stdexcept>
 
-// Specialization to transform enum to string and vice-versa
-namespace datalib
-{
-    // template<class T> std::string to_string(T evalue);
-    // template<class T> T& from_string(const std::string& str, T& evalue);
-}
+// Overloads to transform enum to string and vice-versa
+// Those are looked up by argument dependent lookup, so they must be declared in the namespace of the enumeration
+//
+//  template<class T> std::string to_string(T evalue);
+//  template<class T> T& from_string(const std::string& str, T& evalue);
+//
 
 namespace datalib
 {
@@ -64,8 +64,7 @@ template<class CharT, class Traits, class T> inline
 typename std::enable_if<std::is_enum<T>::value, std::basic_ostream<CharT, Traits>&>::type
 /* std::basic_ostream<CharT, Traits>& */ operator<<(std::basic_ostream<CharT, Traits>& os, const T& value)
 {
-    using namespace datalib;
-    os << datalib::to_string(value);
+    os << to_string(value);
     return os;
 }
 
@@ -6,11 +6,16 @@
 #pragma once
 #include <datalib/data_info/hex.hpp>
 #include <datalib/detail/stream/fwd.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 #include <iomanip>
 
 namespace datalib
 {
 
+template<class T>
+struct min_tokens<hex<T>> : min_tokens<T>
+{};
+
 /*
  *  Input Checker
  */
@@ -27,7 +32,7 @@ basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstream<CharT,
  *  Input
  */
 template<class CharT, class Traits, class T> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, hex<T>& h)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, hex<T>& h)
 {
     auto f = is.setf(std::ios::hex , std::ios::basefield);
     is >> h.get_();
@@ -6,17 +6,23 @@
 #pragma once
 #include <datalib/data_info/ignore.hpp>
 #include <datalib/detail/stream/fwd.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 #include <utility>
 
 namespace datalib {
 
+// The input is ignored but still consumed
+template<class T, class IgTraits>
+struct min_tokens<ignore<T, IgTraits>> : min_tokens<T>
+{};
+
 /*
  *  Input Checker
  */
 template<class CharT, class Traits, typename T, class IgTraits> inline
 basic_icheckstream<CharT, Traits>& operator>>(basic_icheckstream<CharT, Traits>& is, const ignore<T, IgTraits>& ig)
 {
-    basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
+    typename basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
     if(xsentry)
     {
         auto& dummy = *((const T*)(nullptr));
@@ -29,9 +35,9 @@ basic_icheckstream<CharT, Traits>& operator>>(basic_icheckstream<CharT, Traits>&
  *  Input
  */
 template<class CharT, class Traits, class T, class IgTraits> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, ignore<T, IgTraits>& ig)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, ignore<T, IgTraits>& ig)
 {
-    std::basic_istream<CharT, Traits>::sentry xsentry(is);
+    typename datalib::basic_imemstream<CharT, Traits>::sentry xsentry(is);
     if(xsentry)
     {
         T obj;
@@ -46,7 +52,7 @@ std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>&
 template<class CharT, class Traits, class T, class IgTraits> inline
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const ignore<T, IgTraits>& ig)
 {
-    std::basic_ostream<CharT, Traits>::sentry xsentry(os);
+    typename std::basic_ostream<CharT, Traits>::sentry xsentry(os);
     if(xsentry)
     {
         auto obj = IgTraits::output();
@@ -7,6 +7,7 @@
 #define BOOST_OPTIONAL_NO_IOFWD
 #include <datalib/data_info/optional.hpp>
 #include <datalib/detail/stream/fwd.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 
 namespace datalib {
 
@@ -16,9 +17,9 @@ namespace datalib {
 template<class CharT, class Traits, class T> inline
 datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstream<CharT, Traits>& is, const optional<T>& opt)
 {
-    datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is);
-    datalib::basic_icheckstream<CharT, Traits>::sentry xsentry(is);
-    if(xsentry)
+    typename datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is);
+    typename datalib::basic_icheckstream<CharT, Traits>::sentry xsentry(is);
+    if(xsentry && min_tokens<T>::value <= is.remaining_tokens())    // don't even try if there aren't enough tokens left
     {
         // skip optional stuff if necessary
         auto& dummy_ref = *((const T*)(nullptr));
@@ -37,11 +38,11 @@ datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstre
  *  Input
  */
 template<class CharT, class Traits, class T> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, optional<T>& opt)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, optional<T>& opt)
 {
     auto tell = is.tellg(); // before xsentry constructor runs!
-    std::basic_istream<CharT, Traits>::sentry xsentry(is);
-    if(xsentry)
+    typename datalib::basic_imemstream<CharT, Traits>::sentry xsentry(is);
+    if(xsentry && min_tokens<T>::value <= is.remaining_tokens())    // don't even try if there aren't enough tokens left
     {
         T obj;
         if(is >> obj)
@@ -63,7 +64,7 @@ std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>&
 template<class CharT, class Traits, class T> inline
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const optional<T>& opt)
 {
-    std::basic_ostream<CharT, Traits>::sentry xsentry(os);
+    typename std::basic_ostream<CharT, Traits>::sentry xsentry(os);
     if(xsentry)
     {
         if(opt) 
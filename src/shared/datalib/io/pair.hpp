@@ -6,17 +6,24 @@
 #pragma once
 #include <datalib/data_info/pair.hpp>
 #include <datalib/detail/stream/fwd.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 
 namespace datalib {
 
+// Also used by tagged types, which are pairs with a tag (consuming nothing) in the second element
+template<class T1, class T2>
+struct min_tokens<std::pair<T1, T2>> :
+    std::integral_constant<std::size_t, min_tokens<T1>::value + min_tokens<T2>::value>
+{};
+
 /*
  *  Input Checker
  */
 template<class CharT, class Traits, class T1, class T2> inline
 datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstream<CharT, Traits>& is, const std::pair<T1, T2>& pair)
 {
-    datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is, true);
-    datalib::basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
+    typename datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is, true);
+    typename datalib::basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
     if(xsentry)
     {
         ((is >> pair.first) && (is >> pair.second));
@@ -24,18 +31,13 @@ datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstre
     return is;
 }
 
-}
-
-
-namespace std {
-
 /*
  *  Input
  */
 template<class CharT, class Traits, class T1, class T2> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, std::pair<T1, T2>& pair)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, std::pair<T1, T2>& pair)
 {
-    std::basic_istream<CharT, Traits>::sentry xsentry(is);
+    typename datalib::basic_imemstream<CharT, Traits>::sentry xsentry(is);
     if(xsentry)
     {
         ((is >> pair.first) && (is >> pair.second));
@@ -43,16 +45,21 @@ std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>&
     return is;
 }
 
+}
+
+
+namespace std {
+
 /*
  *  Output
  */
 template<class CharT, class Traits, class T1, class T2> inline
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const std::pair<T1, T2>& pair)
 {
-    std::basic_ostream<CharT, Traits>::sentry xsentry(os);
+    typename std::basic_ostream<CharT, Traits>::sentry xsentry(os);
     if(xsentry)
     {
-        ((os << pair.first) && (print_separator<T1>(os)) && (os << pair.second) && (print_separator<T2>(os)));
+        ((os << pair.first) && (datalib::print_separator<T1>(os)) && (os << pair.second) && (datalib::print_separator<T2>(os)));
     }
     return os;
 }
@@ -23,7 +23,7 @@ datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstre
  *  Input
  */
 template<class CharT, class Traits, class T, class Tag> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, tagged_type<T, Tag>& tt)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, tagged_type<T, Tag>& tt)
 {
     return (is >> get(tt));
 }
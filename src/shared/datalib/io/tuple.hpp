@@ -7,6 +7,7 @@
 #include <datalib/data_info/tuple.hpp>
 #include <datalib/detail/stream/fwd.hpp>
 #include <datalib/detail/stream/kstream.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 #include <datalib/detail/mpl/seqeach.hpp>
 
 namespace datalib {
@@ -45,10 +46,10 @@ namespace detail
     struct lambda_tuple_read_val
     {
         Tuple&      tuple;
-        std::istream& stream;
+        imemstream& stream;
 
         // Local-Scope Captures
-        lambda_tuple_read_val(std::istream& stream, Tuple& tuple) :
+        lambda_tuple_read_val(imemstream& stream, Tuple& tuple) :
             stream(stream), tuple(tuple) {}
 
         // The functor
@@ -79,9 +80,27 @@ namespace detail
             return !!stream;
         }
     };
+
+    // Sums min_tokens<> of 'Types...'
+    template<class... Types>
+    struct tuple_min_tokens : std::integral_constant<std::size_t, 0>
+    {};
+
+    template<class T, class... Types>
+    struct tuple_min_tokens<T, Types...> :
+        std::integral_constant<std::size_t, min_tokens<T>::value + tuple_min_tokens<Types...>::value>
+    {};
 }
 
 
+/*
+ *  min_tokens<> specialization for 'std::tuple<Types...>'
+ */
+template<class... Types>
+struct min_tokens<std::tuple<Types...>> : detail::tuple_min_tokens<Types...>
+{};
+
+
 } // namespace datalib
 
 namespace datalib {
@@ -92,36 +111,36 @@ namespace datalib {
 template<class CharT, class Traits, class ...Args> inline
 datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstream<CharT, Traits>& is, const std::tuple<Args...>& tuple)
 {
-    datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is, true);
-    datalib::basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
+    typename datalib::basic_icheckstream<CharT, Traits>::reposer xrepos(is, true);
+    typename datalib::basic_icheckstream<CharT, Traits>::sentry  xsentry(is);
     if(xsentry)
     {
-        datalib::detail::lambda_tuple_check_val<std::decay<decltype(tuple)>::type> fun(is, tuple, xrepos);
+        datalib::detail::lambda_tuple_check_val<typename std::decay<decltype(tuple)>::type> fun(is, tuple, xrepos);
         datalib::foreach_in_tuple(const_cast<std::tuple<Args...>&>(tuple), fun);
         xrepos(!!is);
     }
     return is;
 }
 
-}
-
-namespace std {
-
 /*
  *  Input
  */
 template<class CharT, class Traits, class ...Args> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, std::tuple<Args...>& tuple)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, std::tuple<Args...>& tuple)
 {
-    std::basic_istream<CharT, Traits>::sentry xsentry(is);
+    typename datalib::basic_imemstream<CharT, Traits>::sentry xsentry(is);
     if(xsentry)
     {
-        datalib::detail::lambda_tuple_read_val<std::decay<decltype(tuple)>::type> fun(is, tuple);
+        datalib::detail::lambda_tuple_read_val<typename std::decay<decltype(tuple)>::type> fun(is, tuple);
         datalib::foreach_in_tuple(tuple, fun);
     }
     return is;
 }
 
+}
+
+namespace std {
+
 /*
  *  Output
  */
@@ -129,11 +148,11 @@ template<class CharT, class Traits, class ...Args> inline
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const std::tuple<Args...>& tuple)
 {
     using basic_ostream = std::basic_ostream<CharT, Traits>;
-    basic_ostream::sentry xsentry(os);
+    typename basic_ostream::sentry xsentry(os);
     if(xsentry)
     {
         auto& ncv_tuple = const_cast<std::tuple<Args...>&>(tuple);
-        datalib::detail::lambda_tuple_write_val<std::decay<decltype(tuple)>::type> fun(os, ncv_tuple);
+        datalib::detail::lambda_tuple_write_val<typename std::decay<decltype(tuple)>::type> fun(os, ncv_tuple);
         datalib::foreach_in_tuple(ncv_tuple, fun);
     }
     return os;
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/*
+ *  Directory of IMG archives
+ *
+ *      version::v1 -> the directory is a .dir file next to the .img, it's a plain array of entries with no header (III and VC)
+ *      version::v2 -> the directory is at the start of the .img itself, a "VER2" magic and an entry count preceding the entries (SA)
+ *
+ *      The entries are 32 bytes each, they are read all at once (or in big chunks when the count isn't known) and then validated.
+ *      Any plain 32 bytes structure with the layout of 'entry' can receive them (such as the game's DirectoryInfo).
+ */
+
+namespace img
+{
+    enum class version
+    {
+        v1,     // .dir file
+        v2,     // VER2 header
+    };
+
+    // Result of reading a directory, the entries receive what could be read from it in any case
+    enum class status
+    {
+        good,               // The directory is well formed
+        unreadable,         // The VER2 header couldn't be read
+        bad_magic,          // The VER2 header has a bad magic
+        too_many_entries,   // The directory has more entries than allowed, only the allowed ones were read
+        truncated,          // The directory ends before its last entry does
+        bad_name,           // Some name isn't null terminated, it got terminated at its last character
+    };
+
+    // Entry of a directory
+    struct entry
+    {
+        uint32_t offset;            // Offset of the file in the archive, in blocks
+        uint16_t size;              // Size of the file in blocks, on v1 this is the lower half of an uint32_t
+        uint16_t streaming_size;    // Size of the file when streamed in blocks (v2, zero means 'size'), the higher half of the size on v1
+        char     name[24];          // Null terminated name of the file
+    };
+    static_assert(sizeof(entry) == 32, "Incorrect struct size: img::entry");
+
+    static const uint32_t block_size  = 2048;       // Offsets and sizes are in blocks of this size
+    static const size_t   max_entries = 0x100000;   // Way beyond anything real, protects against garbage counts and files
+
+    // Gets a description of the specified status, for logging
+    inline const char* to_string(status s)
+    {
+        switch(s)
+        {
+            case status::good:              return "good";
+            case status::unreadable:        return "unreadable header";
+            case status::bad_magic:         return "bad magic";
+            case status::too_many_entries:  return "too many entries";
+            case status::truncated:         return "truncated";
+            case status::bad_name:          return "unterminated name";
+        }
+        return "unknown";
+    }
+
+    namespace detail
+    {
+        template<class Entry>
+        inline void check_entry_type()
+        {
+            static_assert(sizeof(Entry) == sizeof(entry) && std::is_pod<Entry>::value, "Entry must have the layout of img::entry");
+        }
+
+        // Terminates any unterminated name, and tells whether there was any
+        template<class Entry>
+        inline bool terminate_names(std::vector<Entry>& entries)
+        {
+            bool good = true;
+            for(auto& e : entries)
+            {
+                auto* name = reinterpret_cast<char*>(&e) + offsetof(entry, name);
+                if(!std::memchr(name, 0, sizeof(entry::name)))
+                {
+                    name[sizeof(entry::name) - 1] = 0;
+                    good = false;
+                }
+            }
+            return good;
+        }
+    }
+
+    /*
+     *  img::parse
+     *      Parses the directory at the 'size' bytes of 'data' (the whole .dir file on v1, or at least the header and the entries on v2)
+     *      into 'entries', which are limited to 'limit' entries
+     */
+    template<class Entry>
+    inline status parse(const void* data, size_t size, version ver, std::vector<Entry>& entries, size_t limit = max_entries)
+    {
+        detail::check_entry_type<Entry>();
+
+        auto* bytes  = static_cast<const char*>(data);
+        status result = status::good;
+        size_t count;
+
+        entries.clear();
+
+        if(ver == version::v2)
+        {
+            uint32_t header_count;
+            if(size < 8)
+                return status::unreadable;
+            if(std::memcmp(bytes, "VER2", 4))
+                return status::bad_magic;
+
+            std::memcpy(&header_count, bytes + 4, sizeof(header_count));
+            bytes += 8; size -= 8;
+
+            count = (std::min)(size_t(header_count), size / sizeof(entry));
+            if(count < header_count)
+                result = status::truncated;
+        }
+        else
+        {
+            count = size / sizeof(entry);
+            if(size % sizeof(entry))
+                result = status::truncated;
+        }
+
+        if(count > limit)
+        {
+            count  = limit;
+            result = status::too_many_entries;
+        }
+
+        entries.resize(count);
+        if(count) std::memcpy(entries.data(), bytes, count * sizeof(entry));
+
+        return (detail::terminate_names(entries) || result != status::good)? result : status::bad_name;
+    }
+
+    /*
+     *  img::read
+     *      Reads the directory from the current position of 'f' into 'entries', which are limited to 'limit' entries
+     *      On v2 the entries are read at once, on v1 they are read in big chunks until the end of the file
+     *      'fread' is the function used to read from 'f', so the reads may go through the game's own fread
+     */
+    template<class Entry, class FRead>
+    inline status read(FILE* f, FRead fread, version ver, std::vector<Entry>& entries, size_t limit = max_entries)
+    {
+        static const size_t chunk_entries = 2048;
+
+        detail::check_entry_type<Entry>();
+
+        status result = status::good;
+        entries.clear();
+
+        if(ver == version::v2)
+        {
+            char magic[4];
+            uint32_t count;
+            size_t readen;
+
+            if(fread(magic, sizeof(magic), 1, f) != 1 || fread(&count, sizeof(count), 1, f) != 1)
+                return status::unreadable;
+            if(std::memcmp(magic, "VER2", 4))
+                return status::bad_magic;
+
+            entries.resize((std::min)(size_t(count), limit));
+            readen = fread(entries.data(), 1, entries.size() * sizeof(entry), f) / sizeof(entry);
+
+            if(readen < entries.size())
+                result = status::truncated;
+            else if(count > limit)
+                result = status::too_many_entries;
+            entries.resize(readen);
+        }
+        else
+        {
+            size_t readen, wanted;
+            do
+            {
+                // Reads one entry beyond the limit, to tell whether there are too many of them
+                auto offset = entries.size();
+                wanted = (std::min)(chunk_entries, limit + 1 - offset);
+                entries.resize(offset + wanted);
+                readen = fread(&entries[offset], 1, wanted * sizeof(entry), f);
+                entries.resize(offset + readen / sizeof(entry));
+
+                if(readen % sizeof(entry))
+                    result = status::truncated;
+                else if(entries.size() > limit)
+                {
+                    entries.resize(limit);
+                    result = status::too_many_entries;
+                }
+            }
+            while(result == status::good && readen == wanted * sizeof(entry));
+        }
+
+        return (detail::terminate_names(entries) || result != status::good)? result : status::bad_name;
+    }
+}
@@ -39,10 +39,17 @@ struct IStreamRefresher
     // Others
     virtual void Clear() = 0;                       // Clears the refresher object so it can perform another refresh
                                                     // (then call RequestRefresh again and so on).
-    virtual void RebuildTxdAssociationMap() = 0;    // On construction this interface builds this association map.
+    virtual void RebuildTxdAssociationMap() = 0;    // std.stream builds this association map the first time a refresh needs it.
                                                     // If txd related to models change, call this method to rebuild the map.
 };
 
+// Version 2 of the interface, returned by StreamRefresherCreate2
+// Methods are only appended to the previous version, so it can be used as a IStreamRefresher as well
+struct IStreamRefresher2 : public IStreamRefresher
+{
+    virtual void UpdateTxdAssociation(uint32_t id) = 0; // Cheaper than RebuildTxdAssociationMap when only the txd of the model 'id' changed.
+};
+
 // Creates a refresher interface if possible, returns a null pointer on failure.
 // The returned pointer should be killed using it->Release();
 inline IStreamRefresher* StreamRefresherCreate(uint32_t capabilities, uint32_t flags)  // flags are reserved, should be 0
@@ -58,3 +65,19 @@ inline IStreamRefresher* StreamRefresherCreate(uint32_t capabilities, uint32_t f
     }
     return nullptr;
 }
+
+// Creates a version 2 refresher interface if possible, returns a null pointer on failure (i.e. std.stream.dll is older than the interface).
+// The returned pointer should be killed using it->Release();
+inline IStreamRefresher2* StreamRefresherCreate2(uint32_t capabilities, uint32_t flags)  // flags are reserved, should be 0
+{
+    if(modloader_shdata_t* data = modloader::plugin_ptr->loader->FindSharedData("StreamRefresherCreate2"))
+    {
+        if(data->type == MODLOADER_SHDATA_FUNCTION)
+        {
+            typedef IStreamRefresher2* (*fStreamCreateRefresher2)(uint32_t, uint32_t);
+            auto StreamCreateRefresher2 = (fStreamCreateRefresher2)(data->f);
+            return StreamCreateRefresher2(capabilities, flags);
+        }
+    }
+    return nullptr;
+}
@@ -6,9 +6,17 @@
 #pragma once
 #include <type_wrapper/datalib/data_info/floating_point.hpp>
 #include <datalib/detail/stream/fwd.hpp>
+#include <datalib/detail/stream/formatter.hpp>
+#include <datalib/detail/stream/tokens.hpp>
 #include <iomanip>
 #include <limits>
 
+namespace datalib {
+    template<class T, class Comp>
+    struct min_tokens<basic_floating_point<T, Comp>> : min_tokens<T>
+    {};
+}
+
 /*
  *  Input Checker
  */
@@ -22,16 +30,20 @@ datalib::basic_icheckstream<CharT, Traits>& operator>>(datalib::basic_icheckstre
  *  Input
  */
 template<class CharT, class Traits, class T, class Comp> inline
-std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, basic_floating_point<T, Comp>& tw)
+datalib::basic_imemstream<CharT, Traits>& operator>>(datalib::basic_imemstream<CharT, Traits>& is, basic_floating_point<T, Comp>& tw)
 {
-    return (is >> std::setprecision(std::numeric_limits<T>::digits10 + 2) >> tw.get_());
+    return (is >> tw.get_());
 }
 
 /*
  *  Output
+ *      Writes the shortest text which reads back into the same value, so the output is stable and as small as possible
  */
 template<class CharT, class Traits, class T, class Comp> inline
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const basic_floating_point<T, Comp>& tw)
 {
+    char buf[64];
+    if(datalib::formatter::format_shortest(buf, sizeof(buf), tw.get_()))
+        return (os << buf);
     return (os << std::setprecision(std::numeric_limits<T>::digits10 + 2) << tw.get_());
 }
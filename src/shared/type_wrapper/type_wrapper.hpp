@@ -159,7 +159,7 @@ namespace std
     template<typename T>
     struct hash<type_wrapper<T>>
     {
-        std::size_t operator()(const type_wrapper& value) const
+        std::size_t operator()(const type_wrapper<T>& value) const
         { return std::hash<T>()(value); }
     };
 
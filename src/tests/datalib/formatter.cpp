@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#include <testing.hpp>
+#include <datalib/detail/stream/formatter.hpp>
+#include <datalib/detail/stream/memstream.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+using namespace datalib;
+
+/*
+ *  Shortest round-trip formatting against golden outputs
+ *
+ *      Only the outputs which are the same in every C runtime are checked literally, the exponent notation
+ *      ("1e+10" against "1e+010" on older runtimes) is checked by reading the output back.
+ */
+
+// Formats 'value' with the shortest round-trip formatter
+template<class T>
+static std::string shortest(T value)
+{
+    char buf[64];
+    auto len = formatter::format_shortest(buf, sizeof(buf), value);
+    return std::string(buf, len);
+}
+
+// Checks that the memory stream prints 'value' just like a string stream does
+template<class T>
+static bool prints_like_sstream(T value)
+{
+    std::string text;
+    std::ostringstream ss;
+    basic_omemstream<char, std::char_traits<char>> os(text);
+    os << value;
+    ss << value;
+    return text == ss.str();
+}
+
+// Checks that 'value' is formatted into text which reads back (the way the game reads it) into the very same value,
+// and that the text is no longer than the text printed with enough digits for any value
+static bool round_trips(float value)
+{
+    char buf[64], full[64];
+    auto len = formatter::format_shortest(buf, sizeof(buf), value);
+    std::snprintf(full, sizeof(full), "%.9g", value);
+    return len != 0 && float(std::strtod(buf, nullptr)) == value && len <= std::strlen(full);
+}
+
+void check_formatter()
+{
+    // Values seen in the stock data files
+    CHECK(shortest(0.0f) == "0");
+    CHECK(shortest(1.0f) == "1");
+    CHECK(shortest(-1.5f) == "-1.5");
+    CHECK(shortest(0.1f) == "0.1");
+    CHECK(shortest(0.3f) == "0.3");
+    CHECK(shortest(-0.35f) == "-0.35");
+    CHECK(shortest(0.85f) == "0.85");
+    CHECK(shortest(0.0025f) == "0.0025");
+    CHECK(shortest(2.5f) == "2.5");
+    CHECK(shortest(1700.0f) == "1700");
+    CHECK(shortest(5008.3f) == "5008.3");
+    CHECK(shortest(-1234.567f) == "-1234.567");
+    CHECK(shortest(2200.25f) == "2200.25");
+    CHECK(shortest(-0.707107f) == "-0.707107");
+
+    // More digits than the default precision of the streams are needed for those
+    CHECK(shortest(3.14159274f) == "3.1415927");
+    CHECK(shortest(1234.5677f) == "1234.5677");
+    CHECK(shortest(16777215.0f) == "16777215");
+
+    // Big integral values are printed in the plain notation when it's shorter than the exponent notation
+    CHECK(shortest(19093090.0f) == "19093090");
+
+    // Doubles
+    CHECK(shortest(0.1) == "0.1");
+    CHECK(shortest(-2.75) == "-2.75");
+    CHECK(shortest(123456.789) == "123456.789");
+
+    // Values printed in the exponent notation, whose text depends on the C runtime
+    CHECK(round_trips(1e10f));
+    CHECK(round_trips(1e-5f));
+    CHECK(round_trips(3.4028235e38f));
+    CHECK(round_trips((std::numeric_limits<float>::min)()));
+    CHECK(round_trips((std::numeric_limits<float>::denorm_min)()));
+
+    // Sweep over the finite floats (of both signs)
+    int bad = 0;
+    for(uint32_t bits = 0; bits < 0x7F800000u; bits += 0x5003u)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if(!round_trips(value) || !round_trips(-value))
+        {
+            if(++bad <= 10) std::printf("%s(%d): %.9g doesn't round trip\n", __FILE__, __LINE__, value);
+        }
+    }
+    CHECK(bad == 0);
+
+    // Integers printed by the memory stream
+    CHECK(prints_like_sstream(0));
+    CHECK(prints_like_sstream(-7));
+    CHECK(prints_like_sstream(1234567u));
+    CHECK(prints_like_sstream((std::numeric_limits<int>::min)()));
+    CHECK(prints_like_sstream((std::numeric_limits<long long>::min)()));
+    CHECK(prints_like_sstream((std::numeric_limits<unsigned long long>::max)()));
+    CHECK(prints_like_sstream(static_cast<unsigned short>(65535)));
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include <testing.hpp>
+#include <datalib/data_slice.hpp>
+#include <datalib/gta3/data_section.hpp>
+#include <cstring>
+#include <string>
+using namespace datalib;
+
+/*
+ *  Lines referring into a buffer
+ *
+ *      The lines of a mapped file are handed to the stores as a boost::string_ref into the file buffer, which isn't
+ *      null terminated at the end of the line. Nothing past the end of the line must be looked at.
+ */
+
+// The slices read only what's inside the line
+static void check_slices()
+{
+    const char buffer[] = "12 3.5 name 99\nnext";
+    boost::string_ref line(buffer, std::strlen("12 3.5 name"));
+
+    data_slice<int, float, std::string> slice;
+    CHECK(slice.check(line));
+    CHECK(slice.set(line));
+    CHECK(get<0>(slice) == 12 && get<1>(slice) == 3.5f && get<2>(slice) == "name");
+
+    data_slice<int, float, std::string, int> longer;
+    CHECK(!longer.check(line));
+    CHECK(!longer.set(line));
+    CHECK(longer.set(boost::string_ref(buffer, std::strlen("12 3.5 name 99"))));
+}
+
+// The sections of a line are found by the line only, with and without the lookup table
+static void check_sections()
+{
+    static auto sections = gta3::make_section_info("objs", "obj", "cars");
+    const char buffer[] = "objsXX cars 1";
+
+    CHECK(gta3::section_info::by_name(sections.data(), boost::string_ref(buffer, 4)) == &sections[0]);
+    CHECK(gta3::section_info::by_name(sections.data(), boost::string_ref(buffer, 3)) == &sections[1]);
+    CHECK(gta3::section_info::by_name(sections.data(), boost::string_ref(buffer, 5)) == nullptr);
+    CHECK(gta3::section_info::by_name(sections.data(), boost::string_ref(buffer, 0)) == nullptr);
+    CHECK(gta3::section_info::by_name(sections.data(), boost::string_ref(buffer + 7, 4), -1) == &sections[2]);
+    CHECK(gta3::section_info::by_name(sections.data(), boost::string_ref(buffer + 7, 3), -1) == nullptr);
+
+    gta3::section_info plain[] = { "objs", "obj", "cars", nullptr };
+    CHECK(gta3::section_info::by_name(plain, boost::string_ref(buffer, 4)) == &plain[0]);
+    CHECK(gta3::section_info::by_name(plain, boost::string_ref(buffer, 3)) == &plain[1]);
+    CHECK(gta3::section_info::by_name(plain, boost::string_ref(buffer, 2)) == nullptr);
+}
+
+void check_lines()
+{
+    check_slices();
+    check_sections();
+}
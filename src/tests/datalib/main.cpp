@@ -0,0 +1,15 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ * 
+ */
+#include <testing.hpp>
+
+void check_scanner();
+void check_formatter();
+void check_lines();
+
+int main()
+{
+    return testing::run({ check_scanner, check_formatter, check_lines });
+}
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2015 Denilson das Mercs Amorim (aka LINK/2012)
+ *  Licensed under the Boost Software License v1.0 (http://opensource.org/licenses/BSL-1.0)
+ *
+ */
+#include <testing.hpp>
+#include <datalib/detail/stream/scanner.hpp>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace datalib;
+
+/*
+ *  Conformance of the scanner against the stream backend
+ *
+ *      Every token of the corpus is read both by the scanner and by a std::istringstream (in the classic locale, which is what
+ *      the imemstream used to do), token for token. Both must accept the same tokens and read the same values out of them.
+ *
+ *      The only tokens the stream accepts but the scanner doesn't are the ones the checker (icheckstream) always rejected,
+ *      since the checker rules are the acceptance rules (see stricter_real and stricter_bool).
+ */
+
+// Reads the whole 'token' through a string stream, the read fails if any character is left behind
+template<class T>
+static bool stream_read(const std::string& token, std::ios::fmtflags flags, T& value)
+{
+    std::istringstream stream(token);
+    stream.imbue(std::locale::classic());
+    stream.flags(flags);
+    return (stream >> value) && stream.peek() == std::char_traits<char>::eof();
+}
+
+// Reads the whole 'token' through the scanner, 'matched' tells whether the matcher accepts it as well
+template<class T>
+static bool scanner_read(const std::string& token, std::ios::fmtflags flags, T& value, bool& matched)
+{
+    const char* begin = token.data();
+    const char* end   = begin + token.size();
+    bool scanned;
+
+    if(std::is_same<T, bool>::value)
+    {
+        bool b = false;
+        scanned = scanner::scan_bool(begin, end, (flags & std::ios::boolalpha) != 0, b) == end;
+        matched = scanner::match_bool(begin, end, (flags & std::ios::boolalpha) != 0) == end;
+        value = T(b);
+    }
+    else if(std::is_floating_point<T>::value)
+    {
+        typename std::conditional<std::is_floating_point<T>::value, T, float>::type x = 0;
+        scanned = scanner::scan_real(begin, end, x) == end;
+        matched = scanner::match_real(begin, end) == end;
+        value = T(x);
+    }
+    else
+    {
+        typename std::conditional<std::is_integral<T>::value && !std::is_same<T, bool>::value, T, int>::type x = 0;
+        scanned = scanner::scan_integer(begin, end, flags & std::ios::basefield, x) == end;
+        matched = scanner::match_integer(begin, end, flags & std::ios::basefield) == end;
+        value = T(x);
+    }
+    return scanned;
+}
+
+// The checker requires at least one digit before the decimal point (the stream accepts ".5")
+static bool stricter_real(const std::string& token)
+{
+    std::size_t i = (!token.empty() && (token[0] == '+' || token[0] == '-'))? 1 : 0;
+    return i < token.size() && token[i] == '.';
+}
+
+// The checker only accepts "0" and "1" as numeric booleans (the stream accepts any spelling of them, such as "+01")
+static bool stricter_bool(const std::string& token)
+{
+    return token != "0" && token != "1";
+}
+
+// Compares the reading of 'token' by the scanner and by the stream as a T
+template<class T>
+static bool conforms(const std::string& token, std::ios::fmtflags flags, bool (*stricter)(const std::string&) = nullptr)
+{
+    T by_scanner = T(), by_stream = T();
+    bool matched;
+    bool scanned  = scanner_read(token, flags, by_scanner, matched);
+    bool streamed = stream_read(token, flags, by_stream);
+
+    // The matcher only validates, so out of range values match but don't scan
+    if(scanned && !matched)
+        return false;
+
+    if(scanned != streamed)
+        return !scanned && stricter && stricter(token);
+    return !scanned || by_scanner == by_stream;
+}
+
+// Corpus of interesting tokens, plus random tokens made of number-like characters (with a fixed seed)
+static std::vector<std::string> make_corpus()
+{
+    std::vector<std::string> corpus = {
+        "0", "1", "-0", "+0", "00", "01", "007", "+7", "-45", "123", "-", "+", "", "a", "12a", "1 ", " 1",
+        "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769", "65535", "65536",
+        "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296", "-1", "-4294967295",
+        "9223372036854775807", "9223372036854775808", "18446744073709551615", "18446744073709551616", "99999999999999999999",
+        "0x", "0x0", "0x1F", "0XaB", "ff", "FFFFFFFF", "100000000", "fg", "-10", "20282000", "440010", "17", "8", "0x10",
+        "1.5", "-0.35", "+2.", "2.", ".5", "-.5", "1.", "1..5", "1.5.", "5008.3", "1e3", "1E3", "2.5E-2", "1.e+2", "1e", "1e+", "1e-",
+        "1.5f", "1e50", "1e-50", "1e400", "1e-400", "3.4028235e38", "3.4028237e38", "1.17549435e-38", "1.4e-45", "0.1",
+        "-1.79769313486231570e308", "inf", "nan", "0x1p3", "true", "false", "TRUE", "tru", "falsee", "10",
+    };
+
+    const char alphabet[] = "+-0123456789abcdefxX.eE";
+    uint32_t seed = 12345;
+    auto random = [&seed] { return (seed = seed * 1664525u + 1013904223u) >> 16; };
+
+    for(int i = 0; i < 100000; ++i)
+    {
+        std::string token(1 + random() % 8, ' ');
+        for(auto& c : token) c = alphabet[random() % (sizeof(alphabet) - 1)];
+        corpus.emplace_back(std::move(token));
+    }
+    return corpus;
+}
+
+void check_scanner()
+{
+    const auto dec = std::ios::dec, hex = std::ios::hex, oct = std::ios::oct;
+
+    int bad = 0;
+    for(auto& token : make_corpus())
+    {
+        bool ok = conforms<int>(token, dec)
+               && conforms<unsigned>(token, dec)
+               && conforms<short>(token, dec)
+               && conforms<unsigned short>(token, dec)
+               && conforms<long long>(token, dec)
+               && conforms<unsigned long long>(token, dec)
+               && conforms<unsigned>(token, hex)
+               && conforms<int>(token, hex)
+               && conforms<int>(token, oct)
+               && conforms<float>(token, dec, stricter_real)
+               && conforms<double>(token, dec, stricter_real)
+               && conforms<bool>(token, dec, stricter_bool)
+               && conforms<bool>(token, dec | std::ios::boolalpha);
+
+        if(!ok && ++bad <= 10)
+            std::printf("%s(%d): scanner and stream disagree on \"%s\"\n", __FILE__, __LINE__, token.c_str());
+    }
+    CHECK(bad == 0);
+
+    // Tokens end at blank spaces, which aren't consumed
+    const char line[] = "  12\t-3.5 word";
+    const char* end = line + sizeof(line) - 1;
+    int i = 0; float f = 0; std::string s;
+    const char* p = scanner::skip_spaces(line, end);
+    CHECK((p = scanner::scan_integer(p, end, dec, i)) != nullptr && i == 12 && *p == '\t');
+    CHECK((p = scanner::scan_real(scanner::skip_spaces(p, end), end, f)) != nullptr && f == -3.5f && *p == ' ');
+    CHECK((p = scanner::scan_string(scanner::skip_spaces(p, end), end, 0, s)) == end && s == "word");
+}
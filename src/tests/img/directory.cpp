@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include <testing.hpp>
+#include <img_parser/img_parser.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ *  Directories of IMG archives
+ *
+ *      Every directory is generated in memory, then read both from memory (img::parse) and from a file (img::read),
+ *      and both must give the same entries and the same status.
+ */
+
+// Makes the entry 'i' of a generated directory
+static img::entry make_entry(uint32_t i)
+{
+    img::entry e;
+    std::memset(&e, 0, sizeof(e));
+    e.offset         = 1 + i * 4;
+    e.size           = uint16_t(1 + i % 4);
+    e.streaming_size = uint16_t(i % 2? e.size : 0);
+    std::snprintf(e.name, sizeof(e.name), "model%u.dff", i);
+    return e;
+}
+
+// Makes the bytes of a directory with 'count' entries, 'header_count' is the count in the VER2 header
+static std::string make_directory(img::version ver, uint32_t count, uint32_t header_count)
+{
+    std::string bytes;
+    if(ver == img::version::v2)
+    {
+        bytes.append("VER2", 4);
+        bytes.append(reinterpret_cast<const char*>(&header_count), sizeof(header_count));
+    }
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        auto e = make_entry(i);
+        bytes.append(reinterpret_cast<const char*>(&e), sizeof(e));
+    }
+    return bytes;
+}
+
+static std::string make_directory(img::version ver, uint32_t count)
+{
+    return make_directory(ver, count, count);
+}
+
+// Reads the directory in 'bytes' from a temporary file
+static img::status read_file(const std::string& bytes, img::version ver, std::vector<img::entry>& entries, size_t limit)
+{
+    img::status result = img::status::unreadable;
+    if(FILE* f = std::tmpfile())
+    {
+        std::fwrite(bytes.data(), 1, bytes.size(), f);
+        std::rewind(f);
+        result = img::read(f, std::fread, ver, entries, limit);
+        std::fclose(f);
+    }
+    return result;
+}
+
+// Reads the directory in 'bytes' both from memory and from a file, checks both agree and gives the result
+static img::status read_both(const std::string& bytes, img::version ver, std::vector<img::entry>& entries,
+                             size_t limit = img::max_entries)
+{
+    std::vector<img::entry> from_file;
+    auto status = img::parse(bytes.data(), bytes.size(), ver, entries, limit);
+    CHECK(read_file(bytes, ver, from_file, limit) == status);
+    CHECK(from_file.size() == entries.size());
+    CHECK(from_file.empty() || !std::memcmp(from_file.data(), entries.data(), entries.size() * sizeof(img::entry)));
+    return status;
+}
+
+// Checks 'entries' are the first entries of a generated directory
+static bool same_entries(const std::vector<img::entry>& entries, size_t count)
+{
+    if(entries.size() != count)
+        return false;
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        auto e = make_entry(i);
+        if(std::memcmp(&entries[i], &e, sizeof(e)))
+            return false;
+    }
+    return true;
+}
+
+// Well formed directories, including one bigger than the chunks the .dir files are read in
+static void check_good()
+{
+    std::vector<img::entry> entries;
+    for(uint32_t count : { 0u, 1u, 100u, 2048u, 5000u })
+    {
+        CHECK(read_both(make_directory(img::version::v1, count), img::version::v1, entries) == img::status::good);
+        CHECK(same_entries(entries, count));
+        CHECK(read_both(make_directory(img::version::v2, count), img::version::v2, entries) == img::status::good);
+        CHECK(same_entries(entries, count));
+    }
+}
+
+// A bad or missing VER2 header gives no entries
+static void check_header()
+{
+    std::vector<img::entry> entries;
+    auto bytes = make_directory(img::version::v2, 10);
+
+    CHECK(read_both(bytes.substr(0, 6), img::version::v2, entries) == img::status::unreadable);
+    CHECK(entries.empty());
+
+    bytes[3] = '1';
+    CHECK(read_both(bytes, img::version::v2, entries) == img::status::bad_magic);
+    CHECK(entries.empty());
+}
+
+// A directory ending in the middle of an entry (or before the count of its header) keeps its whole entries
+static void check_truncated()
+{
+    std::vector<img::entry> entries;
+
+    auto v1 = make_directory(img::version::v1, 10);
+    CHECK(read_both(v1.substr(0, v1.size() - 5), img::version::v1, entries) == img::status::truncated);
+    CHECK(same_entries(entries, 9));
+
+    CHECK(read_both(make_directory(img::version::v2, 10, 12), img::version::v2, entries) == img::status::truncated);
+    CHECK(same_entries(entries, 10));
+
+    auto v2 = make_directory(img::version::v2, 10);
+    CHECK(read_both(v2.substr(0, v2.size() - 5), img::version::v2, entries) == img::status::truncated);
+    CHECK(same_entries(entries, 9));
+}
+
+// Directories with more entries than the limit keep the allowed ones, a .dir file with no count as well
+static void check_limit()
+{
+    std::vector<img::entry> entries;
+
+    CHECK(read_both(make_directory(img::version::v1, 3000), img::version::v1, entries, 2500) == img::status::too_many_entries);
+    CHECK(same_entries(entries, 2500));
+    CHECK(read_both(make_directory(img::version::v1, 2500), img::version::v1, entries, 2500) == img::status::good);
+    CHECK(same_entries(entries, 2500));
+
+    CHECK(read_both(make_directory(img::version::v2, 3000), img::version::v2, entries, 2500) == img::status::too_many_entries);
+    CHECK(same_entries(entries, 2500));
+
+    // A garbage count doesn't make a huge allocation
+    CHECK(read_both(make_directory(img::version::v2, 4, 0xFFFFFFFF), img::version::v2, entries) == img::status::truncated);
+    CHECK(same_entries(entries, 4));
+}
+
+// Unterminated names get terminated at their last character
+static void check_names()
+{
+    std::vector<img::entry> entries;
+    auto bytes = make_directory(img::version::v1, 3);
+    std::memset(&bytes[sizeof(img::entry) + offsetof(img::entry, name)], 'a', sizeof(img::entry::name));
+
+    CHECK(read_both(bytes, img::version::v1, entries) == img::status::bad_name);
+    CHECK(entries.size() == 3);
+    CHECK(std::string(entries[1].name) == std::string(sizeof(img::entry::name) - 1, 'a'));
+    CHECK(std::string(entries[2].name) == "model2.dff");
+}
+
+void check_directory()
+{
+    check_good();
+    check_header();
+    check_truncated();
+    check_limit();
+    check_names();
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ * 
+ */
+#include <testing.hpp>
+#include "host.hpp"
+#include <data_traits/animgrp.hpp>
+#include <vector>
+
+/*
+ *  Merging of animgrp.dat files
+ *
+ *      The groups are the keys of the store, a group found in two files must be the same key (compared by content, not
+ *      by the pointer), otherwise nothing would merge and the output would follow the heap addresses.
+ */
+
+using animgrp_store = gta3::data_store<basic_animgrp_traits<host_data_traits>, store_map<
+                        basic_animgrp_traits<host_data_traits>::key_type, basic_animgrp_traits<host_data_traits>::value_type
+                        >>;
+
+static const char* default_animgrp =
+    "default, ped, man, 3\n"
+    "walk_civi\n"
+    "run_civi\n"
+    "sprint_panic\n"
+    "end\n"
+    "fatman, fat, man, 2\n"
+    "walk_fat\n"
+    "run_fat\n"
+    "end\n";
+
+// Replaces a animation of the default group, the group header is spelled in another case
+static const char* custom_animgrp =
+    "Default, PED, man, 3\n"
+    "walk_civi\n"
+    "run_fast\n"
+    "sprint_panic\n"
+    "end\n"
+    "fatman, fat, man, 2\n"
+    "walk_fat\n"
+    "run_fat\n"
+    "end\n";
+
+// The groups are ordered lexically, and each element is printed followed by a space
+static const char* merged_animgrp =
+    "fatman fat man 2  \n"
+    "walk_fat \n"
+    "run_fat \n"
+    "end \n"
+    "default ped man 3  \n"
+    "walk_civi \n"
+    "run_fast \n"
+    "sprint_panic \n"
+    "end \n";
+
+void check_animgrp()
+{
+    std::vector<animgrp_store> stores(2);
+    stores[0].set_as_default(true);
+    CHECK(stores[0].load_from_file(write_file("animgrp_default.dat", default_animgrp).c_str()));
+    CHECK(stores[1].load_from_file(write_file("animgrp_custom.dat", custom_animgrp).c_str()));
+
+    // The groups of each file are unique by content
+    CHECK(stores[0].traits().grps.size() == 2);
+    CHECK(stores[1].traits().grps.size() == 2);
+
+    // The same group in both files gives the same keys
+    for(auto& pair : stores[1].container())
+        CHECK(stores[0].container().count(pair.first) == 1);
+
+    CHECK(gta3::merge_to_file<animgrp_store>("animgrp_merged.dat", stores.begin(), stores.end(), host_data_traits::domflags_fn()));
+    CHECK(read_file("animgrp_merged.dat") == merged_animgrp);
+
+    std::remove("animgrp_default.dat");
+    std::remove("animgrp_custom.dat");
+    std::remove("animgrp_merged.dat");
+}
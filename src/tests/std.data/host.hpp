@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ * 
+ */
+#pragma once
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#ifndef _WIN32
+#   include <strings.h>
+#endif
+
+//
+//  Stands in for the parts of the plugin host the std.data headers (utility.hpp and the data traits) rely on,
+//  so those can be built into a program of their own. Include this before any std.data header.
+//
+
+#ifndef _WIN32
+inline int _stricmp(const char* a, const char* b)               { return strcasecmp(a, b); }
+inline int _strnicmp(const char* a, const char* b, size_t n)    { return strncasecmp(a, b, n); }
+#endif
+
+// The game version manager, the tests run as San Andreas
+struct host_game_version
+{
+    bool IsIII() const { return false; }
+    bool IsVC() const  { return false; }
+    bool IsSA() const  { return true; }
+};
+static host_game_version gvm;
+
+#include <utility.hpp>
+
+// The path normalization of the plugin host (see modloader/util/path.hpp, which needs windows.h)
+namespace modloader
+{
+    inline std::string NormalizePath(std::string path)
+    {
+        if(path.size())
+        {
+            std::replace(path.begin(), path.end(), '/', '\\');
+            tolower(path);
+            while(path.back() == '/' || path.back() == '\\')
+                path.pop_back();
+            trim(path);
+        }
+        return path;
+    }
+}
+
+// Base traits standing for the data_traits of std.data (see data.hpp), without the plugin services
+struct host_data_traits : public gta3::data_traits
+{
+    static const bool can_cache         = true;
+    static const bool is_reversed_kv    = false;
+
+    static const bool has_eof_string    = false;
+    static const char* eof_string() { return "\n" /* dummy */; };
+
+    using domflags_fn = datalib::domflags_fn<flag_RemoveIfNotExistInOneCustomButInDefault>;
+
+    template<class Archive, class FuncT>
+    static void static_serialize(Archive& archive, bool saving, FuncT serialize_store)
+    {
+        serialize_store();
+    }
+
+    // take care of eof strings and count the failures
+    template<class StoreType, typename TData>
+    static bool setbyline(StoreType& store, TData& data, const gta3::section_info* section, boost::string_ref line, bool allowlog = true)
+    {
+        if(has_reached_eof(store.traits(), line))
+            return false;
+
+        if(!gta3::data_traits::setbyline(store, data, section, line))
+        {
+            if(allowlog) fail(line);
+            return false;
+        }
+        return true;
+    }
+
+    static bool fail(boost::string_ref line)
+    {
+        ++failures();
+        return false;
+    }
+
+    // Number of data lines which failed to parse so far
+    static std::size_t& failures()
+    {
+        static std::size_t count = 0;
+        return count;
+    }
+
+protected:
+
+    template<class traits_type>
+    typename std::enable_if<traits_type::has_eof_string, bool>::type
+    static /* bool */ has_reached_eof(traits_type& traits, boost::string_ref line)
+    {
+        static std::string eof_string = traits_type::eof_string();
+        if(traits.eof || line.starts_with(eof_string))
+        {
+            traits.eof = true;
+            return true;
+        }
+        return false;
+    }
+
+    template<class traits_type>
+    typename std::enable_if<!traits_type::has_eof_string, bool>::type
+    static /* bool */ has_reached_eof(traits_type& traits, boost::string_ref line)
+    {
+        return false;
+    }
+};
+
+// Writes 'content' into the file 'path' and returns the path
+inline std::string write_file(const std::string& path, const std::string& content)
+{
+    if(FILE* f = std::fopen(path.c_str(), "wb"))
+    {
+        std::fwrite(content.data(), 1, content.size(), f);
+        std::fclose(f);
+    }
+    return path;
+}
+
+// Reads the whole file 'path'
+inline std::string read_file(const std::string& path)
+{
+    std::string content;
+    if(FILE* f = std::fopen(path.c_str(), "rb"))
+    {
+        char buf[4096];
+        for(size_t n; (n = std::fread(buf, 1, sizeof(buf), f)) != 0; )
+            content.append(buf, n);
+        std::fclose(f);
+    }
+    return content;
+}
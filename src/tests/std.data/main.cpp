@@ -0,0 +1,13 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ * 
+ */
+#include <testing.hpp>
+
+void check_animgrp();
+
+int main()
+{
+    return testing::run({ check_animgrp });
+}
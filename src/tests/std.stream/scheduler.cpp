@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ *
+ */
+#include <testing.hpp>
+#include <scheduler.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ *  Dispatch and completion of the streaming requests
+ *
+ *      The game is played by the checks themselves: a request is put in the game queue (as CdStreamRead does) only for
+ *      a channel which isn't in use, and the streaming thread takes it from there into the scheduler.
+ *      The reads are done by a fake IO, which records what happens to each channel and may hold the reads of a channel.
+ */
+
+static const int num_channels = 4;
+
+// The game queue, filled by the game and taken by the streaming thread (both played by the same thread here)
+using Queue = std::deque<int>;
+
+struct FakeIO
+{
+    using token_type = int;     // The number of the read
+
+    struct Channel
+    {
+        std::atomic<bool> in_use   { false };   // As CdStream::bInUse
+        std::atomic<int>  in_read  { 0 };       // Reads in flight
+        std::atomic<int>  reads    { 0 };
+        std::atomic<int>  finishes { 0 };
+        std::atomic<bool> overlap  { false };   // Has it ever had more than one read in flight?
+        std::atomic<bool> popped   { false };   // Has the request left the game queue?
+        std::atomic<bool> bad_order{ false };   // Has a request been finished before leaving the game queue, or without a read?
+    };
+
+    Channel channels[num_channels];
+    std::atomic<int> workers_started { 0 };
+    std::atomic<int> reads_on_dispatcher { 0 };
+    std::atomic<int> next_token { 0 };
+
+    // Reads of a held channel wait until it's released
+    std::mutex              mutex;
+    std::condition_variable released;
+    int                     held = -1;
+
+    void Begin(int i)
+    {
+        if(channels[i].popped) channels[i].bad_order = true;
+        channels[i].in_use = true;
+    }
+
+    int Read(int i, int worker)
+    {
+        auto& c = channels[i];
+        if(++c.in_read > 1) c.overlap = true;
+        if(worker < 0) ++reads_on_dispatcher;
+
+        if(true)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            released.wait(lock, [&] { return held != i; });
+        }
+
+        ++c.reads;
+        --c.in_read;
+        return ++next_token;
+    }
+
+    void Finish(int i, int token)
+    {
+        auto& c = channels[i];
+        if(token <= 0 || c.finishes >= c.reads || !c.popped)
+            c.bad_order = true;
+        ++c.finishes;
+        c.popped = false;
+        c.in_use = false;
+    }
+
+    void WorkerStarted(int)
+    {
+        ++workers_started;
+    }
+
+    void Hold(int i)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        held = i;
+    }
+
+    void Release()
+    {
+        if(true)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            held = -1;
+        }
+        released.notify_all();
+    }
+};
+
+// Waits up to a few seconds for 'cond'
+template<class Cond>
+static bool wait_for(Cond cond)
+{
+    for(int i = 0; i < 5000 && !cond(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return cond();
+}
+
+// Requests a read on each channel not in use and runs the streaming thread over the game queue, 'rounds' times
+static void play(FakeIO& io, StreamScheduler<FakeIO>& scheduler, Queue& queue, int rounds)
+{
+    for(int r = 0; r < rounds; ++r)
+    {
+        for(int i = 0; i < num_channels; ++i)
+        {
+            if(!io.channels[i].in_use)
+                queue.push_back(i);
+        }
+
+        while(!queue.empty())
+        {
+            int i = queue.front();
+            scheduler.Process(i, [&] { queue.pop_front(); io.channels[i].popped = true; });
+        }
+    }
+}
+
+// Checks every request has been read and finished once, in order, and with a single read in flight per channel
+static void check_channels(FakeIO& io)
+{
+    for(auto& c : io.channels)
+    {
+        CHECK(c.reads == c.finishes);
+        CHECK(c.reads > 0);
+        CHECK(!c.overlap);
+        CHECK(!c.bad_order);
+        CHECK(!c.in_use);
+    }
+}
+
+// Less than two workers read from the dispatching thread, as the stock streaming thread does
+static void check_no_workers()
+{
+    for(int n : { 0, 1 })
+    {
+        Queue queue;
+        FakeIO io;
+
+        if(true)
+        {
+            StreamScheduler<FakeIO> scheduler(io, n);
+            CHECK(scheduler.Workers() == 0);
+            play(io, scheduler, queue, 10);
+        }
+
+        check_channels(io);
+        CHECK(io.reads_on_dispatcher == 10 * num_channels);
+        CHECK(io.workers_started == 0);
+    }
+}
+
+// Workers read the channels in parallel, and a held channel doesn't hold the others
+static void check_workers()
+{
+    Queue queue;
+    FakeIO io;
+
+    if(true)
+    {
+        StreamScheduler<FakeIO> scheduler(io, num_channels);
+        CHECK(scheduler.Workers() == num_channels);
+        CHECK(wait_for([&] { return io.workers_started == num_channels; }));
+
+        io.Hold(0);
+        play(io, scheduler, queue, 1);
+        CHECK(wait_for([&] { return io.channels[1].finishes == 1 && io.channels[2].finishes == 1 && io.channels[3].finishes == 1; }));
+        CHECK(io.channels[0].in_use && io.channels[0].finishes == 0);
+
+        // The held channel isn't requested again while in use, the others are
+        play(io, scheduler, queue, 1);
+        CHECK(wait_for([&] { return io.channels[3].finishes == 2; }));
+        CHECK(io.channels[0].finishes == 0);
+
+        io.Release();
+        CHECK(wait_for([&] { return io.channels[0].finishes == 1; }));
+    }
+
+    check_channels(io);
+    CHECK(io.reads_on_dispatcher == 0);
+}
+
+// Less workers than channels share the channels, and many requests keep the per channel semantics
+static void check_shared_workers()
+{
+    Queue queue;
+    FakeIO io;
+
+    if(true)
+    {
+        StreamScheduler<FakeIO> scheduler(io, 2);
+        CHECK(scheduler.Workers() == 2);
+        for(int r = 0; r < 200; ++r)
+            play(io, scheduler, queue, 1);
+    }
+
+    check_channels(io);
+    CHECK(io.reads_on_dispatcher == 0);
+    CHECK(io.workers_started == 2);
+}
+
+// The workers finish the requests they've been given before quitting
+static void check_shutdown()
+{
+    Queue queue;
+    FakeIO io;
+
+    if(true)
+    {
+        StreamScheduler<FakeIO> scheduler(io, num_channels);
+        io.Hold(2);
+        play(io, scheduler, queue, 1);
+
+        std::thread releaser([&io]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            io.Release();
+        });
+        scheduler.Shutdown();
+        releaser.join();
+
+        CHECK(scheduler.Workers() == 0);
+    }
+
+    check_channels(io);
+}
+
+void check_scheduler()
+{
+    check_no_workers();
+    check_workers();
+    check_shared_workers();
+    check_shutdown();
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015  LINK/2012 <dma_2012@hotmail.com>
+ * Licensed under the MIT License, see LICENSE at top level directory.
+ * 
+ */
+#pragma once
+#include <cstdio>
+#include <initializer_list>
+
+//
+//  Minimal checking facilities for the test programs
+//  Every failed check is printed, and the program returns the number of failed checks (zero means success)
+//
+
+namespace testing
+{
+    // Number of failed checks so far
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    // Reports a failed check
+    inline void fail(const char* file, int line, const char* what)
+    {
+        ++failures();
+        std::printf("%s(%d): check failed: %s\n", file, line, what);
+    }
+
+    // Runs the check functions and reports the result, to be returned from main()
+    inline int run(std::initializer_list<void(*)()> checks)
+    {
+        for(auto check : checks)
+            check();
+
+        if(failures())
+            std::printf("%d check(s) failed\n", failures());
+        else
+            std::printf("All checks passed\n");
+        return failures();
+    }
+}
+
+#define CHECK(cond) \
+    ((cond)? (void)(0) : testing::fail(__FILE__, __LINE__, #cond))